@@ -0,0 +1,84 @@
+// Compares the platform copy and fill routines against libc.
+// Built with -DPARADISE_BUILD_BENCHMARKS=ON.
+#include "../src/platform/platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef void* (*pfn_copy)(void* dest, const void* source, size_t size);
+typedef void* (*pfn_copy_platform)(void* dest, const void* source, uint64_t size);
+typedef void* (*pfn_set)(void* dest, int value, size_t size);
+typedef void* (*pfn_set_platform)(void* dest, int32_t value, uint64_t size);
+
+// Called through volatile pointers so the compiler cannot see through them.
+static pfn_copy volatile libc_copy = memcpy;
+static pfn_copy_platform volatile engine_copy = platform_copy_memory;
+static pfn_set volatile libc_set = memset;
+static pfn_set_platform volatile engine_set = platform_set_memory;
+
+static double now_seconds() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t iterations_for(uint64_t size) {
+    uint64_t iterations = (512ull * 1024 * 1024) / size;
+    return iterations < 8 ? 8 : (iterations > 4000000 ? 4000000 : iterations);
+}
+
+int main(int argc, char** argv) {
+    const uint64_t sizes[] = {8, 16, 64, 256, 4096, 65536, 262144, 1048576, 4194304, 16777216, 67108864};
+    const uint64_t max_size = 67108864;
+    uint8_t* source = malloc(max_size + 64);
+    uint8_t* dest = malloc(max_size + 64);
+    memset(source, 0x5A, max_size + 64);
+    memset(dest, 0, max_size + 64);
+
+    printf("platform memory path: %s\n", platform_memory_path_name());
+    printf("%10s %12s %12s %12s %12s\n", "size", "memcpy GB/s", "copy GB/s", "memset GB/s", "set GB/s");
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        uint64_t size = sizes[i];
+        uint64_t iterations = iterations_for(size);
+        double gigabytes = (double)size * iterations / 1e9;
+        // Offset by a few bytes so neither side starts aligned.
+        uint8_t* d = dest + 3;
+        uint8_t* s = source + 7;
+
+        double start = now_seconds();
+        for (uint64_t n = 0; n < iterations; ++n) {
+            libc_copy(d, s, size);
+        }
+        double libc_copy_rate = gigabytes / (now_seconds() - start);
+
+        start = now_seconds();
+        for (uint64_t n = 0; n < iterations; ++n) {
+            engine_copy(d, s, size);
+        }
+        double engine_copy_rate = gigabytes / (now_seconds() - start);
+
+        start = now_seconds();
+        for (uint64_t n = 0; n < iterations; ++n) {
+            libc_set(d, (int)n, size);
+        }
+        double libc_set_rate = gigabytes / (now_seconds() - start);
+
+        start = now_seconds();
+        for (uint64_t n = 0; n < iterations; ++n) {
+            engine_set(d, (int32_t)n, size);
+        }
+        double engine_set_rate = gigabytes / (now_seconds() - start);
+
+        if (d[size - 1] != (uint8_t)(iterations - 1)) {
+            printf("%10llu fill check failed\n", (unsigned long long)size);
+            return 1;
+        }
+        printf("%10llu %12.2f %12.2f %12.2f %12.2f\n", (unsigned long long)size, libc_copy_rate, engine_copy_rate, libc_set_rate, engine_set_rate);
+    }
+
+    free(source);
+    free(dest);
+    return 0;
+}
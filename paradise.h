@@ -1,8 +1,8 @@
-﻿// paradise.h: archivo de inclusión para archivos de inclusión estándar del sistema,
-// o archivos de inclusión específicos de un proyecto.
-
-#pragma once
-
-#include <iostream>
-
-// TODO: Haga referencia aquí a los encabezados adicionales que el programa requiere.
+﻿// paradise.h: archivo de inclusión para archivos de inclusión estándar del sistema,
+// o archivos de inclusión específicos de un proyecto.
+
+#pragma once
+
+#include <iostream>
+
+// TODO: Haga referencia aquí a los encabezados adicionales que el programa requiere.
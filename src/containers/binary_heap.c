@@ -0,0 +1,101 @@
+#include "binary_heap.h"
+
+#include "darray.h"
+#include "../core/gmemory.h"
+#include "../core/logger.h"
+
+static uint8_t* binary_heap_at(const binary_heap* heap, uint64_t index) {
+	return heap->elements + index * heap->element_size;
+}
+
+bool binary_heap_create(uint64_t element_size, uint64_t capacity, pfn_binary_heap_compare compare, binary_heap* out_heap) {
+	if (!out_heap || element_size == 0 || !compare) {
+		KERROR("binary_heap_create - requires a heap, a non-zero element size and a compare function.");
+		return false;
+	}
+
+	out_heap->element_size = element_size;
+	out_heap->compare = compare;
+	out_heap->elements = _darray_create(capacity ? capacity : DARRAY_DEFAULT_CAPACITY, element_size);
+	out_heap->scratch = gallocate_flags(element_size, MEMORY_TAG_ARRAY, MEMORY_FLAG_NO_ZERO);
+	return out_heap->elements && out_heap->scratch;
+}
+
+void binary_heap_destroy(binary_heap* heap) {
+	if (heap && heap->elements) {
+		darray_destroy(heap->elements);
+		gfree(heap->scratch, heap->element_size, MEMORY_TAG_ARRAY);
+		gzero_memory(heap, sizeof(binary_heap));
+	}
+}
+
+bool binary_heap_push(binary_heap* heap, const void* element) {
+	uint64_t index = darray_length(heap->elements);
+	heap->elements = _darray_push(heap->elements, element);
+	if (darray_length(heap->elements) == index) {
+		return false;
+	}
+
+	// Move parents down into the hole until the element fits, then drop it in.
+	uint64_t stride = heap->element_size;
+	gcopy_memory(heap->scratch, element, stride);
+	while (index > 0) {
+		uint64_t parent = (index - 1) / 2;
+		if (heap->compare(heap->scratch, binary_heap_at(heap, parent)) >= 0) {
+			break;
+		}
+		gcopy_memory(binary_heap_at(heap, index), binary_heap_at(heap, parent), stride);
+		index = parent;
+	}
+	gcopy_memory(binary_heap_at(heap, index), heap->scratch, stride);
+	return true;
+}
+
+bool binary_heap_pop(binary_heap* heap, void* out_element) {
+	uint64_t length = darray_length(heap->elements);
+	if (length == 0) {
+		return false;
+	}
+
+	uint64_t stride = heap->element_size;
+	if (out_element) {
+		gcopy_memory(out_element, heap->elements, stride);
+	}
+	length--;
+	darray_length_set(heap->elements, length);
+	if (length == 0) {
+		return true;
+	}
+
+	// Sift the old last element down from the root.
+	gcopy_memory(heap->scratch, binary_heap_at(heap, length), stride);
+	uint64_t index = 0;
+	for (;;) {
+		uint64_t child = index * 2 + 1;
+		if (child >= length) {
+			break;
+		}
+		if (child + 1 < length && heap->compare(binary_heap_at(heap, child + 1), binary_heap_at(heap, child)) < 0) {
+			child++;
+		}
+		if (heap->compare(binary_heap_at(heap, child), heap->scratch) >= 0) {
+			break;
+		}
+		gcopy_memory(binary_heap_at(heap, index), binary_heap_at(heap, child), stride);
+		index = child;
+	}
+	gcopy_memory(binary_heap_at(heap, index), heap->scratch, stride);
+	return true;
+}
+
+const void* binary_heap_peek(const binary_heap* heap) {
+	return darray_length(heap->elements) ? heap->elements : 0;
+}
+
+uint64_t binary_heap_length(const binary_heap* heap) {
+	return darray_length(heap->elements);
+}
+
+void binary_heap_clear(binary_heap* heap) {
+	darray_clear(heap->elements);
+}
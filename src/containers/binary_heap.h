@@ -0,0 +1,30 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Priority queue over fixed size elements, stored as an implicit binary tree
+// in a darray. Push and pop are O(log n); peeking at the front is O(1).
+
+// Negative when a must come out before b.
+typedef int32_t (*pfn_binary_heap_compare)(const void* a, const void* b);
+
+typedef struct binary_heap {
+	uint64_t element_size;
+	pfn_binary_heap_compare compare;
+	// darray of elements, front at index 0.
+	uint8_t* elements;
+	// One element of room for sifting.
+	uint8_t* scratch;
+} binary_heap;
+
+bool binary_heap_create(uint64_t element_size, uint64_t capacity, pfn_binary_heap_compare compare, binary_heap* out_heap);
+void binary_heap_destroy(binary_heap* heap);
+
+bool binary_heap_push(binary_heap* heap, const void* element);
+// Copies the front element to out_element when it is not 0. False when empty.
+bool binary_heap_pop(binary_heap* heap, void* out_element);
+// The front element, or 0 when empty. Valid until the next push or pop.
+const void* binary_heap_peek(const binary_heap* heap);
+
+uint64_t binary_heap_length(const binary_heap* heap);
+void binary_heap_clear(binary_heap* heap);
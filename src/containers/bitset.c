@@ -0,0 +1,262 @@
+#include "bitset.h"
+
+#include "../core/gmemory.h"
+#include "../core/logger.h"
+#include "../platform/platform.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BITSET_X64 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BITSET_AVX2
+#else
+// Every AVX2 CPU also has POPCNT.
+#define BITSET_AVX2 __attribute__((target("avx2,popcnt")))
+#endif
+#endif
+
+// Checked once, on the first bitset created.
+static bool use_avx2 = false;
+
+static uint32_t bitset_ctz64(uint64_t word) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return (uint32_t)index;
+#else
+	return (uint32_t)__builtin_ctzll(word);
+#endif
+}
+
+// Portable population count for CPUs without POPCNT.
+static uint64_t bitset_popcount_swar(uint64_t word) {
+	word = word - ((word >> 1) & 0x5555555555555555ull);
+	word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+	word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+	return (word * 0x0101010101010101ull) >> 56;
+}
+
+static uint64_t bitset_tail_mask(const bitset* set) {
+	uint64_t used = set->bit_count & 63;
+	return used ? (1ull << used) - 1 : ~0ull;
+}
+
+bool bitset_create(uint64_t bit_count, uint64_t* memory, bitset* out_set) {
+	if (!out_set || bit_count == 0) {
+		KERROR("bitset_create - requires a bitset and a non-zero bit count.");
+		return false;
+	}
+
+#if BITSET_X64
+	use_avx2 = platform_cpu_supports_avx2();
+#endif
+
+	out_set->bit_count = bit_count;
+	out_set->word_count = BITSET_WORD_COUNT(bit_count);
+	out_set->owns_memory = memory == 0;
+	if (memory) {
+		out_set->words = memory;
+		gzero_memory(memory, out_set->word_count * sizeof(uint64_t));
+	} else {
+		// Zeroed by the allocator.
+		out_set->words = gallocate_flags(out_set->word_count * sizeof(uint64_t), MEMORY_TAG_ARRAY, MEMORY_FLAG_ALIGN_64);
+		if (!out_set->words) {
+			KERROR("bitset_create - failed to allocate %llu bits.", bit_count);
+			return false;
+		}
+	}
+	return true;
+}
+
+void bitset_destroy(bitset* set) {
+	if (set && set->words) {
+		if (set->owns_memory) {
+			gfree_flags(set->words, set->word_count * sizeof(uint64_t), MEMORY_TAG_ARRAY, MEMORY_FLAG_ALIGN_64);
+		}
+		gzero_memory(set, sizeof(bitset));
+	}
+}
+
+void bitset_set_all(bitset* set) {
+	uint64_t used_words = (set->bit_count + 63) / 64;
+	gset_memory(set->words, 0xff, used_words * sizeof(uint64_t));
+	set->words[used_words - 1] &= bitset_tail_mask(set);
+}
+
+void bitset_clear_all(bitset* set) {
+	gzero_memory(set->words, set->word_count * sizeof(uint64_t));
+}
+
+#if BITSET_X64
+BITSET_AVX2 static void bitset_combine_avx2(uint64_t* dest, const uint64_t* a, const uint64_t* b, bitset_op op, uint64_t word_count) {
+	// Word counts are whole blocks, so there is never a partial vector.
+	for (uint64_t i = 0; i < word_count; i += 4) {
+		__m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+		__m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+		__m256i result;
+		switch (op) {
+			case BITSET_OP_AND:
+				result = _mm256_and_si256(x, y);
+				break;
+			case BITSET_OP_OR:
+				result = _mm256_or_si256(x, y);
+				break;
+			case BITSET_OP_XOR:
+				result = _mm256_xor_si256(x, y);
+				break;
+			default:
+				result = _mm256_andnot_si256(y, x);
+				break;
+		}
+		_mm256_storeu_si256((__m256i*)(dest + i), result);
+	}
+}
+
+BITSET_AVX2 static uint64_t bitset_count_avx2(const uint64_t* words, uint64_t word_count) {
+	uint64_t count = 0;
+	for (uint64_t i = 0; i < word_count; ++i) {
+		count += (uint64_t)_mm_popcnt_u64(words[i]);
+	}
+	return count;
+}
+
+// Every x64 CPU has SSE2.
+static void bitset_combine_sse2(uint64_t* dest, const uint64_t* a, const uint64_t* b, bitset_op op, uint64_t word_count) {
+	for (uint64_t i = 0; i < word_count; i += 2) {
+		__m128i x = _mm_loadu_si128((const __m128i*)(a + i));
+		__m128i y = _mm_loadu_si128((const __m128i*)(b + i));
+		__m128i result;
+		switch (op) {
+			case BITSET_OP_AND:
+				result = _mm_and_si128(x, y);
+				break;
+			case BITSET_OP_OR:
+				result = _mm_or_si128(x, y);
+				break;
+			case BITSET_OP_XOR:
+				result = _mm_xor_si128(x, y);
+				break;
+			default:
+				result = _mm_andnot_si128(y, x);
+				break;
+		}
+		_mm_storeu_si128((__m128i*)(dest + i), result);
+	}
+}
+#else
+static void bitset_combine_scalar(uint64_t* dest, const uint64_t* a, const uint64_t* b, bitset_op op, uint64_t word_count) {
+	for (uint64_t i = 0; i < word_count; ++i) {
+		switch (op) {
+			case BITSET_OP_AND:
+				dest[i] = a[i] & b[i];
+				break;
+			case BITSET_OP_OR:
+				dest[i] = a[i] | b[i];
+				break;
+			case BITSET_OP_XOR:
+				dest[i] = a[i] ^ b[i];
+				break;
+			default:
+				dest[i] = a[i] & ~b[i];
+				break;
+		}
+	}
+}
+#endif
+
+void bitset_combine_blocks(bitset* dest, const bitset* a, const bitset* b, bitset_op op, uint64_t first_block, uint64_t block_count) {
+	if (dest->bit_count != a->bit_count || dest->bit_count != b->bit_count) {
+		KERROR("bitset_combine - bit counts differ (%llu, %llu, %llu).", dest->bit_count, a->bit_count, b->bit_count);
+		return;
+	}
+	uint64_t total = bitset_block_count(dest);
+	if (first_block >= total) {
+		return;
+	}
+	if (block_count > total - first_block) {
+		block_count = total - first_block;
+	}
+
+	uint64_t first = first_block * BITSET_BLOCK_WORDS;
+	uint64_t word_count = block_count * BITSET_BLOCK_WORDS;
+#if BITSET_X64
+	if (use_avx2) {
+		bitset_combine_avx2(dest->words + first, a->words + first, b->words + first, op, word_count);
+	} else {
+		bitset_combine_sse2(dest->words + first, a->words + first, b->words + first, op, word_count);
+	}
+#else
+	bitset_combine_scalar(dest->words + first, a->words + first, b->words + first, op, word_count);
+#endif
+}
+
+void bitset_combine(bitset* dest, const bitset* a, const bitset* b, bitset_op op) {
+	bitset_combine_blocks(dest, a, b, op, 0, bitset_block_count(dest));
+}
+
+uint64_t bitset_count_blocks(const bitset* set, uint64_t first_block, uint64_t block_count) {
+	uint64_t total = bitset_block_count(set);
+	if (first_block >= total) {
+		return 0;
+	}
+	if (block_count > total - first_block) {
+		block_count = total - first_block;
+	}
+
+	const uint64_t* words = set->words + first_block * BITSET_BLOCK_WORDS;
+	uint64_t word_count = block_count * BITSET_BLOCK_WORDS;
+#if BITSET_X64
+	if (use_avx2) {
+		return bitset_count_avx2(words, word_count);
+	}
+#endif
+	uint64_t count = 0;
+	for (uint64_t i = 0; i < word_count; ++i) {
+		count += bitset_popcount_swar(words[i]);
+	}
+	return count;
+}
+
+uint64_t bitset_count(const bitset* set) {
+	return bitset_count_blocks(set, 0, bitset_block_count(set));
+}
+
+bool bitset_any(const bitset* set) {
+	for (uint64_t i = 0; i < set->word_count; ++i) {
+		if (set->words[i]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool bitset_equals(const bitset* a, const bitset* b) {
+	if (a->bit_count != b->bit_count) {
+		return false;
+	}
+	for (uint64_t i = 0; i < a->word_count; ++i) {
+		if (a->words[i] != b->words[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+uint64_t bitset_find_next(const bitset* set, uint64_t from) {
+	if (from >= set->bit_count) {
+		return BITSET_NOT_FOUND;
+	}
+
+	uint64_t index = from >> 6;
+	// Drop the bits below from in its word.
+	uint64_t word = set->words[index] & (~0ull << (from & 63));
+	uint64_t used_words = (set->bit_count + 63) / 64;
+	while (!word) {
+		if (++index >= used_words) {
+			return BITSET_NOT_FOUND;
+		}
+		word = set->words[index];
+	}
+	return (index << 6) + bitset_ctz64(word);
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Fixed size set of bits stored as 64-bit words. Storage is rounded up to
+// whole 512 bit blocks, one cache line each, so work can be split across
+// threads on block boundaries without two threads writing the same line.
+// Bits past bit_count are kept zero.
+
+#define BITSET_BLOCK_BITS 512
+#define BITSET_BLOCK_WORDS (BITSET_BLOCK_BITS / 64)
+#define BITSET_NOT_FOUND UINT64_MAX
+
+// Words of storage a bitset of bit_count bits needs.
+#define BITSET_WORD_COUNT(bit_count) ((((bit_count) + BITSET_BLOCK_BITS - 1) / BITSET_BLOCK_BITS) * BITSET_BLOCK_WORDS)
+
+typedef struct bitset {
+	uint64_t bit_count;
+	// Always a multiple of BITSET_BLOCK_WORDS.
+	uint64_t word_count;
+	uint64_t* words;
+	bool owns_memory;
+} bitset;
+
+typedef enum bitset_op {
+	BITSET_OP_AND,
+	BITSET_OP_OR,
+	BITSET_OP_XOR,
+	// a & ~b
+	BITSET_OP_ANDNOT
+} bitset_op;
+
+// memory may be 0 to allocate it, or caller owned storage of at least
+// BITSET_WORD_COUNT(bit_count) words. Either way it starts cleared.
+bool bitset_create(uint64_t bit_count, uint64_t* memory, bitset* out_set);
+void bitset_destroy(bitset* set);
+
+void bitset_set_all(bitset* set);
+void bitset_clear_all(bitset* set);
+
+// dest = a op b. All three must have the same bit count; dest may be a or b.
+void bitset_combine(bitset* dest, const bitset* a, const bitset* b, bitset_op op);
+// Same over blocks [first_block, first_block + block_count), for splitting
+// the work across jobs.
+void bitset_combine_blocks(bitset* dest, const bitset* a, const bitset* b, bitset_op op, uint64_t first_block, uint64_t block_count);
+
+uint64_t bitset_count(const bitset* set);
+uint64_t bitset_count_blocks(const bitset* set, uint64_t first_block, uint64_t block_count);
+bool bitset_any(const bitset* set);
+bool bitset_equals(const bitset* a, const bitset* b);
+
+// Index of the first set bit at or after from, or BITSET_NOT_FOUND. Walk every
+// set bit with:
+// for (uint64_t i = bitset_find_next(set, 0); i != BITSET_NOT_FOUND; i = bitset_find_next(set, i + 1))
+uint64_t bitset_find_next(const bitset* set, uint64_t from);
+
+static inline uint64_t bitset_block_count(const bitset* set) {
+	return set->word_count / BITSET_BLOCK_WORDS;
+}
+
+// Single bit access, also usable on raw words for bitsets embedded in structs.
+static inline bool bitset_words_test(const uint64_t* words, uint64_t bit) {
+	return (words[bit >> 6] >> (bit & 63)) & 1;
+}
+
+static inline void bitset_words_assign(uint64_t* words, uint64_t bit, bool value) {
+	uint64_t mask = 1ull << (bit & 63);
+	words[bit >> 6] = value ? words[bit >> 6] | mask : words[bit >> 6] & ~mask;
+}
+
+static inline bool bitset_test(const bitset* set, uint64_t bit) {
+	return bitset_words_test(set->words, bit);
+}
+
+static inline void bitset_set(bitset* set, uint64_t bit) {
+	set->words[bit >> 6] |= 1ull << (bit & 63);
+}
+
+static inline void bitset_clear(bitset* set, uint64_t bit) {
+	set->words[bit >> 6] &= ~(1ull << (bit & 63));
+}
+
+static inline void bitset_assign(bitset* set, uint64_t bit, bool value) {
+	bitset_words_assign(set->words, bit, value);
+}
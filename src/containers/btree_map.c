@@ -0,0 +1,533 @@
+#include "btree_map.h"
+
+#include "../core/gmemory.h"
+#include "../core/logger.h"
+#include "../memory/pool_allocator.h"
+#include "../platform/platform.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BTREE_MAP_X64 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define BTREE_MAP_AVX2
+#else
+#define BTREE_MAP_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#define BTREE_MAP_NODE_ALIGNMENT 64
+#define BTREE_MAP_POOL_SLAB_SIZE (64 * 1024)
+#define BTREE_MAP_SPLIT (BTREE_MAP_NODE_KEYS / 2)
+
+// Unused key slots hold UINT64_MAX so a node can be searched without
+// looking at its count.
+typedef struct btree_map_node {
+	uint64_t keys[BTREE_MAP_NODE_KEYS];
+	uint16_t count;
+	uint16_t is_leaf;
+} btree_map_node;
+
+// keys[i] is the largest key child i may hold; the last child has no bound.
+typedef struct btree_map_inner {
+	btree_map_node node;
+	btree_map_node* children[BTREE_MAP_NODE_KEYS + 1];
+} btree_map_inner;
+
+// Values follow at btree_map_leaf_values.
+typedef struct btree_map_leaf {
+	btree_map_node node;
+	struct btree_map_leaf* prev;
+	struct btree_map_leaf* next;
+} btree_map_leaf;
+
+#define BTREE_MAP_LEAF_HEADER_SIZE ((sizeof(btree_map_leaf) + 15) & ~(uint64_t)15)
+
+static bool use_avx2 = false;
+
+static uint8_t* btree_map_leaf_values(const btree_map_leaf* leaf) {
+	return (uint8_t*)leaf + BTREE_MAP_LEAF_HEADER_SIZE;
+}
+
+#if BTREE_MAP_X64
+BTREE_MAP_AVX2 static uint32_t btree_map_count_less_avx2(const uint64_t* keys, uint32_t count, uint64_t key) {
+	// AVX2 only compares signed, so flip the sign bit of both sides.
+	__m256i bias = _mm256_set1_epi64x(INT64_MIN);
+	__m256i search = _mm256_xor_si256(_mm256_set1_epi64x((int64_t)key), bias);
+	__m256i less = _mm256_setzero_si256();
+	// The padding past count never compares less, so whole vectors are safe.
+	for (uint32_t i = 0; i < count; i += 4) {
+		__m256i block = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(keys + i)), bias);
+		// Each matching lane is -1.
+		less = _mm256_sub_epi64(less, _mm256_cmpgt_epi64(search, block));
+	}
+	__m128i sum = _mm_add_epi64(_mm256_castsi256_si128(less), _mm256_extracti128_si256(less, 1));
+	return (uint32_t)(_mm_cvtsi128_si64(sum) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(sum, sum)));
+}
+#endif
+
+// Number of keys below key, which is both the lower bound in a leaf and the
+// child to descend into in an inner node.
+static uint32_t btree_map_count_less(const btree_map_node* node, uint64_t key) {
+#if BTREE_MAP_X64
+	if (use_avx2) {
+		return btree_map_count_less_avx2(node->keys, node->count, key);
+	}
+#endif
+	uint32_t low = 0;
+	uint32_t high = node->count;
+	while (low < high) {
+		uint32_t middle = (low + high) / 2;
+		if (node->keys[middle] < key) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+static btree_map_node* btree_map_node_allocate(btree_map* map, bool is_leaf) {
+	uint32_t size = is_leaf ? map->leaf_size : map->inner_size;
+	btree_map_node* node = pool_allocator_allocate(map->pool, size);
+	if (!node) {
+		KERROR("btree_map - failed to allocate a %uB node.", size);
+		return 0;
+	}
+	gset_memory(node->keys, 0xff, sizeof(node->keys));
+	node->count = 0;
+	node->is_leaf = is_leaf;
+	if (is_leaf) {
+		((btree_map_leaf*)node)->prev = 0;
+		((btree_map_leaf*)node)->next = 0;
+	}
+	return node;
+}
+
+static void btree_map_node_free(btree_map* map, btree_map_node* node) {
+	pool_allocator_free(map->pool, node, node->is_leaf ? map->leaf_size : map->inner_size);
+}
+
+static void btree_map_free_subtree(btree_map* map, btree_map_node* node) {
+	if (!node->is_leaf) {
+		btree_map_inner* inner = (btree_map_inner*)node;
+		for (uint32_t i = 0; i <= node->count; ++i) {
+			btree_map_free_subtree(map, inner->children[i]);
+		}
+	}
+	btree_map_node_free(map, node);
+}
+
+void btree_map_node_sizes(uint64_t value_size, uint32_t* out_inner_size, uint32_t* out_leaf_size) {
+	uint64_t align = BTREE_MAP_NODE_ALIGNMENT - 1;
+	*out_inner_size = (uint32_t)((sizeof(btree_map_inner) + align) & ~align);
+	*out_leaf_size = (uint32_t)((BTREE_MAP_LEAF_HEADER_SIZE + value_size * BTREE_MAP_NODE_KEYS + align) & ~align);
+}
+
+bool btree_map_create(uint64_t value_size, struct pool_allocator* pool, btree_map* out_map) {
+	if (!out_map || value_size == 0) {
+		KERROR("btree_map_create - requires a map and a non-zero value size.");
+		return false;
+	}
+
+#if BTREE_MAP_X64
+	use_avx2 = platform_cpu_supports_avx2();
+#endif
+
+	gzero_memory(out_map, sizeof(btree_map));
+	out_map->value_size = value_size;
+	btree_map_node_sizes(value_size, &out_map->inner_size, &out_map->leaf_size);
+	if (pool) {
+		out_map->pool = pool;
+		return true;
+	}
+
+	// The pool registers its own address, so it cannot live inside the map.
+	pool_allocator_config config = {0};
+	config.name = "btree_map";
+	config.tag = MEMORY_TAG_BST;
+	uint32_t small = out_map->inner_size < out_map->leaf_size ? out_map->inner_size : out_map->leaf_size;
+	uint32_t large = out_map->inner_size < out_map->leaf_size ? out_map->leaf_size : out_map->inner_size;
+	config.class_sizes[config.class_count++] = small;
+	if (large != small) {
+		config.class_sizes[config.class_count++] = large;
+	}
+	config.slab_size = BTREE_MAP_POOL_SLAB_SIZE;
+	if (config.slab_size < 64 + (uint64_t)large * 8) {
+		config.slab_size = 64 + (uint64_t)large * 8;
+	}
+
+	out_map->pool = gallocate(sizeof(pool_allocator), MEMORY_TAG_BST);
+	if (!out_map->pool || !pool_allocator_create(&config, out_map->pool)) {
+		KERROR("btree_map_create - failed to create the node pool.");
+		return false;
+	}
+	out_map->owns_pool = true;
+	return true;
+}
+
+void btree_map_destroy(btree_map* map) {
+	if (!map || !map->pool) {
+		return;
+	}
+	btree_map_clear(map);
+	if (map->owns_pool) {
+		pool_allocator_destroy(map->pool);
+		gfree(map->pool, sizeof(pool_allocator), MEMORY_TAG_BST);
+	}
+	gzero_memory(map, sizeof(btree_map));
+}
+
+void btree_map_clear(btree_map* map) {
+	if (map->root) {
+		btree_map_free_subtree(map, map->root);
+	}
+	map->root = 0;
+	map->depth = 0;
+	map->count = 0;
+}
+
+static btree_map_leaf* btree_map_find_leaf(const btree_map* map, uint64_t key) {
+	btree_map_node* node = map->root;
+	while (node && !node->is_leaf) {
+		node = ((btree_map_inner*)node)->children[btree_map_count_less(node, key)];
+	}
+	return (btree_map_leaf*)node;
+}
+
+void* btree_map_find(const btree_map* map, uint64_t key) {
+	btree_map_leaf* leaf = btree_map_find_leaf(map, key);
+	if (!leaf) {
+		return 0;
+	}
+	uint32_t index = btree_map_count_less(&leaf->node, key);
+	if (index < leaf->node.count && leaf->node.keys[index] == key) {
+		return btree_map_leaf_values(leaf) + index * map->value_size;
+	}
+	return 0;
+}
+
+bool btree_map_contains(const btree_map* map, uint64_t key) {
+	return btree_map_find(map, key) != 0;
+}
+
+// Inserts separator and right child after child slot in a non-full inner node.
+static void btree_map_inner_insert(btree_map_inner* inner, uint32_t slot, uint64_t separator, btree_map_node* right) {
+	btree_map_node* node = &inner->node;
+	for (uint32_t i = node->count; i > slot; --i) {
+		node->keys[i] = node->keys[i - 1];
+		inner->children[i + 1] = inner->children[i];
+	}
+	node->keys[slot] = separator;
+	inner->children[slot + 1] = right;
+	node->count++;
+}
+
+void* btree_map_emplace(btree_map* map, uint64_t key, bool* out_inserted) {
+	if (out_inserted) {
+		*out_inserted = false;
+	}
+	if (!map->root) {
+		map->root = btree_map_node_allocate(map, true);
+		if (!map->root) {
+			return 0;
+		}
+		map->depth = 1;
+	}
+
+	btree_map_inner* path[BTREE_MAP_MAX_DEPTH];
+	uint32_t slots[BTREE_MAP_MAX_DEPTH];
+	uint32_t level = 0;
+	btree_map_node* node = map->root;
+	while (!node->is_leaf) {
+		path[level] = (btree_map_inner*)node;
+		slots[level] = btree_map_count_less(node, key);
+		node = path[level]->children[slots[level]];
+		level++;
+	}
+
+	btree_map_leaf* leaf = (btree_map_leaf*)node;
+	uint32_t index = btree_map_count_less(node, key);
+	uint64_t stride = map->value_size;
+	if (index < node->count && node->keys[index] == key) {
+		return btree_map_leaf_values(leaf) + index * stride;
+	}
+
+	if (node->count == BTREE_MAP_NODE_KEYS) {
+		// The split climbs through every full ancestor. Allocate all the new
+		// nodes up front so a failure leaves the tree untouched.
+		uint32_t full_parents = 0;
+		while (full_parents < level && path[level - 1 - full_parents]->node.count == BTREE_MAP_NODE_KEYS) {
+			full_parents++;
+		}
+		bool new_root = full_parents == level;
+		if (new_root && map->depth >= BTREE_MAP_MAX_DEPTH) {
+			KERROR("btree_map_emplace - tree is at its maximum depth of %u.", BTREE_MAP_MAX_DEPTH);
+			return 0;
+		}
+		btree_map_node* spares[BTREE_MAP_MAX_DEPTH + 1];
+		uint32_t spare_count = 1 + full_parents + (new_root ? 1 : 0);
+		for (uint32_t i = 0; i < spare_count; ++i) {
+			spares[i] = btree_map_node_allocate(map, i == 0);
+			if (!spares[i]) {
+				while (i-- > 0) {
+					btree_map_node_free(map, spares[i]);
+				}
+				return 0;
+			}
+		}
+		uint32_t spare = 1;
+
+		btree_map_leaf* right = (btree_map_leaf*)spares[0];
+
+		// Upper half of the keys and values moves to the new right leaf.
+		uint32_t moved = BTREE_MAP_NODE_KEYS - BTREE_MAP_SPLIT;
+		gcopy_memory(right->node.keys, node->keys + BTREE_MAP_SPLIT, moved * sizeof(uint64_t));
+		gcopy_memory(btree_map_leaf_values(right), btree_map_leaf_values(leaf) + BTREE_MAP_SPLIT * stride, moved * stride);
+		gset_memory(node->keys + BTREE_MAP_SPLIT, 0xff, moved * sizeof(uint64_t));
+		right->node.count = (uint16_t)moved;
+		node->count = BTREE_MAP_SPLIT;
+
+		right->prev = leaf;
+		right->next = leaf->next;
+		if (leaf->next) {
+			leaf->next->prev = right;
+		}
+		leaf->next = right;
+
+		btree_map_leaf* target = leaf;
+		if (index > BTREE_MAP_SPLIT) {
+			target = right;
+			index -= BTREE_MAP_SPLIT;
+		}
+		uint8_t* values = btree_map_leaf_values(target);
+		memmove(values + (index + 1) * stride, values + index * stride, (target->node.count - index) * stride);
+		for (uint32_t i = target->node.count; i > index; --i) {
+			target->node.keys[i] = target->node.keys[i - 1];
+		}
+		target->node.keys[index] = key;
+		target->node.count++;
+		gzero_memory(values + index * stride, stride);
+		void* result = values + index * stride;
+
+		// Push the split up until a parent has room or a new root is needed.
+		uint64_t separator = node->keys[node->count - 1];
+		btree_map_node* new_child = &right->node;
+		while (level > 0) {
+			level--;
+			btree_map_inner* parent = path[level];
+			uint32_t slot = slots[level];
+			if (parent->node.count < BTREE_MAP_NODE_KEYS) {
+				btree_map_inner_insert(parent, slot, separator, new_child);
+				new_child = 0;
+				break;
+			}
+
+			// Build the overfull node in scratch, then split it around the middle key.
+			uint64_t keys[BTREE_MAP_NODE_KEYS + 1];
+			btree_map_node* children[BTREE_MAP_NODE_KEYS + 2];
+			for (uint32_t i = 0, k = 0; i <= BTREE_MAP_NODE_KEYS; ++i) {
+				keys[i] = i == slot ? separator : parent->node.keys[k++];
+			}
+			for (uint32_t i = 0, c = 0; i <= BTREE_MAP_NODE_KEYS + 1; ++i) {
+				children[i] = i == slot + 1 ? new_child : parent->children[c++];
+			}
+
+			btree_map_inner* sibling = (btree_map_inner*)spares[spare++];
+			gset_memory(parent->node.keys, 0xff, sizeof(parent->node.keys));
+			for (uint32_t i = 0; i < BTREE_MAP_SPLIT; ++i) {
+				parent->node.keys[i] = keys[i];
+			}
+			for (uint32_t i = 0; i <= BTREE_MAP_SPLIT; ++i) {
+				parent->children[i] = children[i];
+			}
+			parent->node.count = BTREE_MAP_SPLIT;
+
+			uint32_t right_count = BTREE_MAP_NODE_KEYS - BTREE_MAP_SPLIT;
+			for (uint32_t i = 0; i < right_count; ++i) {
+				sibling->node.keys[i] = keys[BTREE_MAP_SPLIT + 1 + i];
+			}
+			for (uint32_t i = 0; i <= right_count; ++i) {
+				sibling->children[i] = children[BTREE_MAP_SPLIT + 1 + i];
+			}
+			sibling->node.count = (uint16_t)right_count;
+
+			separator = keys[BTREE_MAP_SPLIT];
+			new_child = &sibling->node;
+		}
+
+		if (new_child) {
+			btree_map_inner* root = (btree_map_inner*)spares[spare++];
+			root->node.keys[0] = separator;
+			root->node.count = 1;
+			root->children[0] = map->root;
+			root->children[1] = new_child;
+			map->root = &root->node;
+			map->depth++;
+		}
+
+		map->count++;
+		if (out_inserted) {
+			*out_inserted = true;
+		}
+		return result;
+	}
+
+	uint8_t* values = btree_map_leaf_values(leaf);
+	memmove(values + (index + 1) * stride, values + index * stride, (node->count - index) * stride);
+	for (uint32_t i = node->count; i > index; --i) {
+		node->keys[i] = node->keys[i - 1];
+	}
+	node->keys[index] = key;
+	node->count++;
+	gzero_memory(values + index * stride, stride);
+
+	map->count++;
+	if (out_inserted) {
+		*out_inserted = true;
+	}
+	return values + index * stride;
+}
+
+bool btree_map_set(btree_map* map, uint64_t key, const void* value) {
+	void* slot = btree_map_emplace(map, key, 0);
+	if (!slot) {
+		return false;
+	}
+	gcopy_memory(slot, value, map->value_size);
+	return true;
+}
+
+bool btree_map_remove(btree_map* map, uint64_t key, void* out_value) {
+	if (!map->root) {
+		return false;
+	}
+
+	btree_map_inner* path[BTREE_MAP_MAX_DEPTH];
+	uint32_t slots[BTREE_MAP_MAX_DEPTH];
+	uint32_t level = 0;
+	btree_map_node* node = map->root;
+	while (!node->is_leaf) {
+		path[level] = (btree_map_inner*)node;
+		slots[level] = btree_map_count_less(node, key);
+		node = path[level]->children[slots[level]];
+		level++;
+	}
+
+	uint32_t index = btree_map_count_less(node, key);
+	if (index >= node->count || node->keys[index] != key) {
+		return false;
+	}
+
+	btree_map_leaf* leaf = (btree_map_leaf*)node;
+	uint64_t stride = map->value_size;
+	uint8_t* values = btree_map_leaf_values(leaf);
+	if (out_value) {
+		gcopy_memory(out_value, values + index * stride, stride);
+	}
+	node->count--;
+	memmove(values + index * stride, values + (index + 1) * stride, (node->count - index) * stride);
+	for (uint32_t i = index; i < node->count; ++i) {
+		node->keys[i] = node->keys[i + 1];
+	}
+	node->keys[node->count] = UINT64_MAX;
+	map->count--;
+
+	if (node->count > 0) {
+		return true;
+	}
+
+	// Free the empty leaf, and every ancestor it leaves empty. Separators
+	// stay valid as upper bounds, so nothing else needs fixing.
+	if (leaf->prev) {
+		leaf->prev->next = leaf->next;
+	}
+	if (leaf->next) {
+		leaf->next->prev = leaf->prev;
+	}
+	btree_map_node_free(map, node);
+	node = 0;
+
+	while (level > 0) {
+		level--;
+		btree_map_inner* parent = path[level];
+		uint32_t slot = slots[level];
+		if (parent->node.count == 0) {
+			// That was its only child.
+			btree_map_node_free(map, &parent->node);
+			continue;
+		}
+
+		// Drop the child and one separator next to it: its own, or the one
+		// before it when it was the unbounded last child.
+		uint32_t key_slot = slot < parent->node.count ? slot : slot - 1;
+		for (uint32_t i = key_slot; i + 1 < parent->node.count; ++i) {
+			parent->node.keys[i] = parent->node.keys[i + 1];
+		}
+		for (uint32_t i = slot; i < parent->node.count; ++i) {
+			parent->children[i] = parent->children[i + 1];
+		}
+		parent->node.count--;
+		parent->node.keys[parent->node.count] = UINT64_MAX;
+		node = &parent->node;
+		break;
+	}
+
+	if (!node) {
+		// The whole tree emptied.
+		map->root = 0;
+		map->depth = 0;
+		return true;
+	}
+
+	// Collapse roots left with a single child.
+	while (!map->root->is_leaf && map->root->count == 0) {
+		btree_map_node* old_root = map->root;
+		map->root = ((btree_map_inner*)old_root)->children[0];
+		btree_map_node_free(map, old_root);
+		map->depth--;
+	}
+	return true;
+}
+
+btree_map_iterator btree_map_range(const btree_map* map, uint64_t first, uint64_t last) {
+	btree_map_iterator iterator = {0};
+	iterator.last = last;
+	iterator.value_size = map->value_size;
+	iterator.leaf = btree_map_find_leaf(map, first);
+	if (iterator.leaf) {
+		iterator.index = btree_map_count_less(&iterator.leaf->node, first);
+	}
+	return iterator;
+}
+
+btree_map_iterator btree_map_lower_bound(const btree_map* map, uint64_t key) {
+	return btree_map_range(map, key, UINT64_MAX);
+}
+
+btree_map_iterator btree_map_begin(const btree_map* map) {
+	return btree_map_range(map, 0, UINT64_MAX);
+}
+
+bool btree_map_next(btree_map_iterator* iterator, uint64_t* out_key, void** out_value) {
+	while (iterator->leaf && iterator->index >= iterator->leaf->node.count) {
+		iterator->leaf = iterator->leaf->next;
+		iterator->index = 0;
+	}
+	if (!iterator->leaf) {
+		return false;
+	}
+
+	uint64_t key = iterator->leaf->node.keys[iterator->index];
+	if (key > iterator->last) {
+		iterator->leaf = 0;
+		return false;
+	}
+	if (out_key) {
+		*out_key = key;
+	}
+	if (out_value) {
+		*out_value = btree_map_leaf_values(iterator->leaf) + iterator->index * iterator->value_size;
+	}
+	iterator->index++;
+	return true;
+}
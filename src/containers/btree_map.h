@@ -0,0 +1,91 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Ordered map from uint64_t keys to fixed size values, as a B+ tree. Nodes
+// hold BTREE_MAP_NODE_KEYS keys in one contiguous array that is searched with
+// AVX2 when the CPU has it, so a lookup touches a few cache lines per level
+// instead of one pointer per comparison. Values live in the leaves, which are
+// linked in key order for iteration and range queries.
+//
+// Nodes come from a pool allocator. A node is freed as soon as it empties
+// rather than merged with its neighbours, which keeps removal cheap; lookups
+// stay logarithmic in the number of keys ever inserted.
+//
+// Anything that sorts as an unsigned 64-bit integer works as a key:
+// timestamps, packed id/version pairs, Morton codes.
+
+#define BTREE_MAP_NODE_KEYS 32
+#define BTREE_MAP_MAX_DEPTH 16
+
+struct pool_allocator;
+struct btree_map_node;
+struct btree_map_leaf;
+
+typedef struct btree_map {
+	uint64_t value_size;
+	uint64_t count;
+	uint32_t depth;
+	// Pool block sizes of the two node kinds.
+	uint32_t inner_size;
+	uint32_t leaf_size;
+	bool owns_pool;
+	struct pool_allocator* pool;
+	struct btree_map_node* root;
+} btree_map;
+
+// Walks keys in ascending order up to and including last.
+typedef struct btree_map_iterator {
+	const struct btree_map_leaf* leaf;
+	uint32_t index;
+	uint64_t last;
+	uint64_t value_size;
+} btree_map_iterator;
+
+// pool may be 0 for a private pool. A shared pool needs size classes that fit
+// btree_map_node_sizes(value_size), which lets many small maps share slabs.
+bool btree_map_create(uint64_t value_size, struct pool_allocator* pool, btree_map* out_map);
+void btree_map_destroy(btree_map* map);
+void btree_map_node_sizes(uint64_t value_size, uint32_t* out_inner_size, uint32_t* out_leaf_size);
+
+// Returns the value stored for key, or 0.
+void* btree_map_find(const btree_map* map, uint64_t key);
+bool btree_map_contains(const btree_map* map, uint64_t key);
+
+// Returns the value slot for key, inserting it when missing. A new slot's
+// value is zeroed. Returns 0 only when a node allocation fails. Value
+// pointers stay valid until the next insert or remove.
+void* btree_map_emplace(btree_map* map, uint64_t key, bool* out_inserted);
+// Inserts or overwrites.
+bool btree_map_set(btree_map* map, uint64_t key, const void* value);
+// Copies the removed value to out_value when it is not 0.
+bool btree_map_remove(btree_map* map, uint64_t key, void* out_value);
+void btree_map_clear(btree_map* map);
+
+// Every key from first to last, inclusive. btree_map_lower_bound(map, key) is
+// btree_map_range(map, key, UINT64_MAX). Inserting or removing invalidates
+// iterators.
+btree_map_iterator btree_map_range(const btree_map* map, uint64_t first, uint64_t last);
+btree_map_iterator btree_map_lower_bound(const btree_map* map, uint64_t key);
+btree_map_iterator btree_map_begin(const btree_map* map);
+// Returns the current entry and steps past it, or false at the end.
+bool btree_map_next(btree_map_iterator* iterator, uint64_t* out_key, void** out_value);
+
+// Generates typed inline wrappers, e.g. BTREE_MAP_DEFINE(asset_versions, uint32_t)
+// gives btree_map_asset_versions_set(map, key, value) and friends.
+#define BTREE_MAP_DEFINE(name, value_type)														\
+	static inline bool btree_map_##name##_create(struct pool_allocator* pool, btree_map* out_map) {	\
+		return btree_map_create(sizeof(value_type), pool, out_map);								\
+	}																							\
+	static inline value_type* btree_map_##name##_find(const btree_map* map, uint64_t key) {	\
+		return (value_type*)btree_map_find(map, key);											\
+	}																							\
+	static inline bool btree_map_##name##_set(btree_map* map, uint64_t key, value_type value) {	\
+		return btree_map_set(map, key, &value);													\
+	}																							\
+	static inline bool btree_map_##name##_remove(btree_map* map, uint64_t key) {				\
+		return btree_map_remove(map, key, 0);													\
+	}																							\
+	static inline bool btree_map_##name##_next(btree_map_iterator* iterator, uint64_t* out_key, value_type** out_value) {	\
+		return btree_map_next(iterator, out_key, (void**)out_value);							\
+	}
@@ -1,117 +1,318 @@
-#include "darray.h"
-
-#include "../core/gmemory.h"
-#include "../core/logger.h"
-
-void* _darray_create(uint64_t lenght, uint64_t stride) {
-	uint64_t header_size = DARRAY_FIELD_LENGTH * sizeof(uint64_t);
-	uint64_t array_size = lenght * stride;
-	uint64_t* new_array = gallocate(header_size + array_size, MEMORY_TAG_DARRAY);
-	gset_memory(new_array, 0, header_size + array_size);
-	new_array[DARRAY_CAPACITY] = lenght;
-	new_array[DARRAY_LENGTH] = 0;
-	new_array[DARRAY_STRIDE] = stride;
-	return (void*)(new_array + DARRAY_FIELD_LENGTH);
-}
-
-void _darray_destroy(void* array) {
-	uint64_t* header = (uint64_t*)array - DARRAY_FIELD_LENGTH;
-	uint64_t header_size = DARRAY_FIELD_LENGTH * sizeof(uint64_t);
-	uint64_t total_size = header_size + header[DARRAY_CAPACITY] * header[DARRAY_STRIDE];
-	gfree(header, total_size, MEMORY_TAG_DARRAY);
-}
-
-uint64_t _darray_field_get(void* array, uint64_t field) {
-	uint64_t* header = (uint64_t*)array - DARRAY_FIELD_LENGTH;
-	return header[field];
-}
-
-void _darray_field_set(void* array, uint64_t field, uint64_t value) {
-	uint64_t* header = (uint64_t*)array - DARRAY_FIELD_LENGTH;
-	header[field] = value;
-}
-
-void* _darray_resize(void* array) {
-	uint64_t length = darray_length(array);
-	uint64_t stride = darray_stride(array);
-	void* temp = _darray_create(
-		(DARRAY_RESIZE_FACTOR * darray_capacity(array)),
-		stride);
-	gcopy_memory(temp, array, length * stride);
-
-	_darray_field_set(temp, DARRAY_LENGTH, length);
-	_darray_destroy(array);
-	return temp; 
-}
-
-void* _darray_push(void* array, const void* value_ptr) {
-	uint64_t length = darray_length(array);
-	uint64_t stride = darray_stride(array);
-	if (length >= darray_capacity(array)) {
-		array = _darray_resize(array);
-	}
-
-	uint64_t addr = (uint64_t)array;
-	addr += (length * stride);
-	gcopy_memory((void*)addr, value_ptr, stride);
-	_darray_field_set(array, DARRAY_LENGTH, length + 1);
-	return array;
-}
-
-void _darray_pop(void* array, void* dest) {
-	uint64_t length = darray_length(array);
-	uint64_t stride = darray_stride(array);
-	uint64_t addr = (uint64_t)array;
-	addr += ((length - 1) * stride);
-	gcopy_memory(dest, (void*)addr, stride);
-	_darray_field_set(array, DARRAY_LENGTH, length - 1);
-}
-
-void* _darray_pop_at(void* array, uint64_t index, void* dest) {
-	uint64_t length = darray_length(array);
-	uint64_t stride = darray_stride(array);
-	if (index >= length) {
-		KERROR("Index outside the bounds of this array! Length: %i, index: %index", length, index);
-		return array;
-	}
-
-	uint64_t addr = (uint64_t)array;
-	gcopy_memory(dest, (void*)(addr + (index * stride)), stride);
-
-	if (index != length - 1) {
-		gcopy_memory(
-			(void*)(addr + (index * stride)),
-			(void*)(addr + ((index + 1) * stride)),
-			stride * (length - index));
-		
-	}
-
-	_darray_field_set(array, DARRAY_LENGTH, length - 1);
-	return array;
-}
-
-void* _darray_insert_at(void* array, uint64_t index, void* value_ptr) {
-	uint64_t length = darray_length(array);
-	uint64_t stride = darray_stride(array);
-	if (index >= length) {
-		KERROR("Index outside the bounds of this array! Length: %i, index: %index", length, index);
-		return array;
-	}
-	if (length >= darray_capacity(array)) {
-		array = _darray_resize(array);
-	}
-
-	uint64_t addr = (uint64_t)array;
-
-	if (index != length - 1) {
-		gcopy_memory(
-			(void*)(addr + ((index + 1) * stride)),
-			(void*)(addr + (index * stride)),
-			stride * (length - index));
-	}
-
-	gcopy_memory((void*)(addr + (index * stride)), value_ptr, stride);
-
-	_darray_field_set(array, DARRAY_LENGTH, length + 1);
-	return array;
-}
\ No newline at end of file
+#include "darray.h"
+
+#include "../core/gmemory.h"
+#include "../core/logger.h"
+#include "../memory/linear_allocator.h"
+#include "../memory/frame_allocator.h"
+#include "../memory/pool_allocator.h"
+
+#define DARRAY_HEADER_SIZE (DARRAY_FIELD_LENGTH * sizeof(uint64_t))
+// Keeps the header and 16 byte aligned elements aligned inside arenas.
+#define DARRAY_ARENA_ALIGNMENT 16
+
+// Arena a linear or frame backed array allocates from.
+static linear_allocator* darray_arena(darray_allocator_type type, void* instance) {
+	if (type == DARRAY_ALLOCATOR_FRAME) {
+		frame_allocator* frame = instance;
+		return &frame->arenas[frame->current_frame];
+	}
+	return instance;
+}
+
+// Returns the header of a block with room for at least capacity elements,
+// writing the capacity that actually fits back. Pools that cannot fit the
+// block fall back to the heap and change the type.
+static uint64_t* darray_block_allocate(uint64_t* capacity, uint64_t stride, darray_allocator_type* type, void* instance, memory_flags flags) {
+	uint64_t size = DARRAY_HEADER_SIZE + *capacity * stride;
+	uint64_t* header = 0;
+	switch (*type) {
+		case DARRAY_ALLOCATOR_LINEAR:
+		case DARRAY_ALLOCATOR_FRAME:
+			header = linear_allocator_allocate_aligned(darray_arena(*type, instance), size, DARRAY_ARENA_ALIGNMENT);
+			if (header && !(flags & MEMORY_FLAG_NO_ZERO)) {
+				gzero_memory(header, size);
+			}
+			return header;
+		case DARRAY_ALLOCATOR_POOL: {
+			pool_allocator* pool = instance;
+			uint32_t largest = pool->classes[pool->class_count - 1].block_size;
+			if (size <= largest) {
+				header = pool_allocator_allocate(pool, size);
+				if (header) {
+					// Use the whole block the size class hands out.
+					for (uint32_t i = 0; i < pool->class_count; ++i) {
+						if (size <= pool->classes[i].block_size) {
+							*capacity = stride ? (pool->classes[i].block_size - DARRAY_HEADER_SIZE) / stride : *capacity;
+							size = DARRAY_HEADER_SIZE + *capacity * stride;
+							break;
+						}
+					}
+					if (!(flags & MEMORY_FLAG_NO_ZERO)) {
+						gzero_memory(header, size);
+					}
+				}
+				return header;
+			}
+			*type = DARRAY_ALLOCATOR_HEAP;
+		}
+		// fallthrough
+		case DARRAY_ALLOCATOR_HEAP:
+		default:
+			return gallocate_flags(size, MEMORY_TAG_DARRAY, flags);
+	}
+}
+
+static void darray_block_free(uint64_t* header) {
+	uint64_t size = DARRAY_HEADER_SIZE + header[DARRAY_CAPACITY] * header[DARRAY_STRIDE];
+	void* instance = (void*)header[DARRAY_ALLOCATOR];
+	switch ((darray_allocator_type)header[DARRAY_ALLOCATOR_TYPE]) {
+		case DARRAY_ALLOCATOR_LINEAR:
+		case DARRAY_ALLOCATOR_FRAME: {
+			// The newest block can be handed back; the rest go at the next reset.
+			linear_allocator* arena = darray_arena((darray_allocator_type)header[DARRAY_ALLOCATOR_TYPE], instance);
+			if ((uint8_t*)header + size == (uint8_t*)arena->memory + arena->allocated) {
+				linear_allocator_rollback(arena, (uint64_t)((uint8_t*)header - (uint8_t*)arena->memory));
+			}
+			break;
+		}
+		case DARRAY_ALLOCATOR_POOL:
+			pool_allocator_free(instance, header, size);
+			break;
+		case DARRAY_ALLOCATOR_HEAP:
+		default:
+			gfree(header, size, MEMORY_TAG_DARRAY);
+			break;
+	}
+}
+
+static void* darray_allocate(uint64_t capacity, uint64_t stride, darray_allocator allocator, memory_flags flags) {
+	uint64_t* new_array = darray_block_allocate(&capacity, stride, &allocator.type, allocator.instance, flags);
+	if (!new_array) {
+		KERROR("darray_create - failed to allocate %llu elements of %lluB.", capacity, stride);
+		return 0;
+	}
+	new_array[DARRAY_CAPACITY] = capacity;
+	new_array[DARRAY_LENGTH] = 0;
+	new_array[DARRAY_STRIDE] = stride;
+	new_array[DARRAY_ALLOCATOR_TYPE] = allocator.type;
+	new_array[DARRAY_ALLOCATOR] = allocator.type == DARRAY_ALLOCATOR_HEAP ? 0 : (uint64_t)allocator.instance;
+	new_array[DARRAY_RESERVED] = 0;
+	return (void*)(new_array + DARRAY_FIELD_LENGTH);
+}
+
+void* _darray_create(uint64_t lenght, uint64_t stride) {
+	return darray_allocate(lenght, stride, DARRAY_HEAP, MEMORY_FLAG_NONE);
+}
+
+void* _darray_create_from(uint64_t capacity, uint64_t stride, darray_allocator allocator) {
+	return darray_allocate(capacity, stride, allocator, MEMORY_FLAG_NONE);
+}
+
+void _darray_destroy(void* array) {
+	darray_block_free((uint64_t*)array - DARRAY_FIELD_LENGTH);
+}
+
+uint64_t _darray_field_get(void* array, uint64_t field) {
+	uint64_t* header = (uint64_t*)array - DARRAY_FIELD_LENGTH;
+	return header[field];
+}
+
+void _darray_field_set(void* array, uint64_t field, uint64_t value) {
+	uint64_t* header = (uint64_t*)array - DARRAY_FIELD_LENGTH;
+	header[field] = value;
+}
+
+void* _darray_reserve(void* array, uint64_t capacity) {
+	uint64_t* header = (uint64_t*)array - DARRAY_FIELD_LENGTH;
+	uint64_t old_capacity = header[DARRAY_CAPACITY];
+	if (capacity <= old_capacity) {
+		return array;
+	}
+
+	uint64_t stride = header[DARRAY_STRIDE];
+	darray_allocator_type type = (darray_allocator_type)header[DARRAY_ALLOCATOR_TYPE];
+	void* instance = (void*)header[DARRAY_ALLOCATOR];
+	if (type == DARRAY_ALLOCATOR_HEAP) {
+		// Grown in place when the heap allows. Only the first length elements
+		// are ever read, so the new tail is left unzeroed.
+		uint64_t* new_header = greallocate_flags(
+			header,
+			DARRAY_HEADER_SIZE + old_capacity * stride,
+			DARRAY_HEADER_SIZE + capacity * stride,
+			MEMORY_TAG_DARRAY,
+			MEMORY_FLAG_NO_ZERO);
+		if (!new_header) {
+			return array;
+		}
+
+		new_header[DARRAY_CAPACITY] = capacity;
+		return (void*)(new_header + DARRAY_FIELD_LENGTH);
+	}
+
+	if (type == DARRAY_ALLOCATOR_LINEAR || type == DARRAY_ALLOCATOR_FRAME) {
+		if (linear_allocator_try_extend(
+				darray_arena(type, instance),
+				header,
+				DARRAY_HEADER_SIZE + old_capacity * stride,
+				DARRAY_HEADER_SIZE + capacity * stride)) {
+			header[DARRAY_CAPACITY] = capacity;
+			return array;
+		}
+	}
+
+	uint64_t* new_header = darray_block_allocate(&capacity, stride, &type, instance, MEMORY_FLAG_NO_ZERO);
+	if (!new_header) {
+		return array;
+	}
+
+	gcopy_memory(new_header, header, DARRAY_HEADER_SIZE + header[DARRAY_LENGTH] * stride);
+	new_header[DARRAY_CAPACITY] = capacity;
+	new_header[DARRAY_ALLOCATOR_TYPE] = type;
+	new_header[DARRAY_ALLOCATOR] = type == DARRAY_ALLOCATOR_HEAP ? 0 : (uint64_t)instance;
+	darray_block_free(header);
+	return (void*)(new_header + DARRAY_FIELD_LENGTH);
+}
+
+void* _darray_resize(void* array) {
+	uint64_t capacity = darray_capacity(array);
+	return _darray_reserve(array, capacity ? capacity * DARRAY_RESIZE_FACTOR : DARRAY_DEFAULT_CAPACITY);
+}
+
+void* _darray_shrink_to_fit(void* array) {
+	uint64_t* header = (uint64_t*)array - DARRAY_FIELD_LENGTH;
+	uint64_t length = header[DARRAY_LENGTH];
+	// Arena space is only returned on reset and pool blocks come in fixed
+	// sizes, so only heap arrays shrink.
+	if (length == header[DARRAY_CAPACITY] || header[DARRAY_ALLOCATOR_TYPE] != DARRAY_ALLOCATOR_HEAP) {
+		return array;
+	}
+
+	uint64_t stride = header[DARRAY_STRIDE];
+	uint64_t* new_header = greallocate_flags(
+		header,
+		DARRAY_HEADER_SIZE + header[DARRAY_CAPACITY] * stride,
+		DARRAY_HEADER_SIZE + length * stride,
+		MEMORY_TAG_DARRAY,
+		MEMORY_FLAG_NO_ZERO);
+	if (!new_header) {
+		return array;
+	}
+
+	new_header[DARRAY_CAPACITY] = length;
+	return (void*)(new_header + DARRAY_FIELD_LENGTH);
+}
+
+void* _darray_push(void* array, const void* value_ptr) {
+	uint64_t length = darray_length(array);
+	uint64_t stride = darray_stride(array);
+	if (length >= darray_capacity(array)) {
+		array = _darray_resize(array);
+		if (length >= darray_capacity(array)) {
+			return array;
+		}
+	}
+
+	uint64_t addr = (uint64_t)array;
+	addr += (length * stride);
+	gcopy_memory((void*)addr, value_ptr, stride);
+	_darray_field_set(array, DARRAY_LENGTH, length + 1);
+	return array;
+}
+
+void* _darray_push_n(void* array, const void* values, uint64_t count) {
+	uint64_t length = darray_length(array);
+	uint64_t stride = darray_stride(array);
+	uint64_t capacity = darray_capacity(array);
+	if (length + count > capacity) {
+		// Grow geometrically so repeated small appends stay amortized.
+		uint64_t new_capacity = capacity * DARRAY_RESIZE_FACTOR;
+		array = _darray_reserve(array, new_capacity > length + count ? new_capacity : length + count);
+		if (length + count > darray_capacity(array)) {
+			return array;
+		}
+	}
+
+	gcopy_memory((uint8_t*)array + length * stride, values, count * stride);
+	_darray_field_set(array, DARRAY_LENGTH, length + count);
+	return array;
+}
+
+void _darray_pop(void* array, void* dest) {
+	uint64_t length = darray_length(array);
+	uint64_t stride = darray_stride(array);
+	uint64_t addr = (uint64_t)array;
+	addr += ((length - 1) * stride);
+	gcopy_memory(dest, (void*)addr, stride);
+	_darray_field_set(array, DARRAY_LENGTH, length - 1);
+}
+
+void* _darray_pop_at(void* array, uint64_t index, void* dest) {
+	uint64_t length = darray_length(array);
+	uint64_t stride = darray_stride(array);
+	if (index >= length) {
+		KERROR("Index outside the bounds of this array! Length: %llu, index: %llu", length, index);
+		return array;
+	}
+
+	uint64_t addr = (uint64_t)array;
+	gcopy_memory(dest, (void*)(addr + (index * stride)), stride);
+
+	if (index != length - 1) {
+		// The ranges overlap.
+		memmove(
+			(void*)(addr + (index * stride)),
+			(void*)(addr + ((index + 1) * stride)),
+			stride * (length - index - 1));
+	}
+
+	_darray_field_set(array, DARRAY_LENGTH, length - 1);
+	return array;
+}
+
+void* _darray_insert_at(void* array, uint64_t index, void* value_ptr) {
+	uint64_t length = darray_length(array);
+	uint64_t stride = darray_stride(array);
+	if (index > length) {
+		KERROR("Index outside the bounds of this array! Length: %llu, index: %llu", length, index);
+		return array;
+	}
+	if (length >= darray_capacity(array)) {
+		array = _darray_resize(array);
+		if (length >= darray_capacity(array)) {
+			return array;
+		}
+	}
+
+	uint64_t addr = (uint64_t)array;
+
+	if (index != length) {
+		// The ranges overlap.
+		memmove(
+			(void*)(addr + ((index + 1) * stride)),
+			(void*)(addr + (index * stride)),
+			stride * (length - index));
+	}
+
+	gcopy_memory((void*)(addr + (index * stride)), value_ptr, stride);
+
+	_darray_field_set(array, DARRAY_LENGTH, length + 1);
+	return array;
+}
+
+void _darray_swap_remove(void* array, uint64_t index, void* dest) {
+	uint64_t length = darray_length(array);
+	uint64_t stride = darray_stride(array);
+	if (index >= length) {
+		KERROR("Index outside the bounds of this array! Length: %llu, index: %llu", length, index);
+		return;
+	}
+
+	uint8_t* element = (uint8_t*)array + index * stride;
+	if (dest) {
+		gcopy_memory(dest, element, stride);
+	}
+	if (index != length - 1) {
+		gcopy_memory(element, (uint8_t*)array + (length - 1) * stride, stride);
+	}
+	_darray_field_set(array, DARRAY_LENGTH, length - 1);
+}
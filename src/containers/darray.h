@@ -1,71 +1,198 @@
-#pragma once
-#include <stdint.h>
-
-enum {
-	DARRAY_CAPACITY,
-	DARRAY_LENGTH,
-	DARRAY_STRIDE,
-	DARRAY_FIELD_LENGTH
-};
-
-void* _darray_create(uint64_t lenght, uint64_t stride);
-void  _darray_destroy(void* array);
-
-uint64_t _darray_field_get(void* array, uint64_t field);
-void     _darray_field_set(void* array, uint64_t field, uint64_t value);
-
-void* _darray_resize(void* array);
-
-void* _darray_push(void* array, const void* value_ptr);
-void  _darray_pop(void* array, void* dest);
-
-void* _darray_pop_at(void* array, uint64_t index, void* dest);
-void* _darray_insert_at(void* array, uint64_t index, void* value_ptr);
-
-#define DARRAY_DEFAULT_CAPACITY 1
-#define DARRAY_RESIZE_FACTOR 2
-
-#define darray_create(type) \
-		_darray_create(DARRAY_DEFAULT_CAPACITY, sizeof(type))
-
-#define darray_reserve(type, capacity) \
-		_darray_create(capacity, sizeof(type))
-
-#define darray_destroy(array) _darray_destroy(array);
-
-
-
-#define darray_push(array, value)	\
-	{								\
-		typeof(value) temp = value;				\
-		array = _darray_push(array, &temp); \
-	}
-
-
-#define darray_pop(array, value_ptr) \
-		_darray_pop(array, value_ptr)
-
-#define darray_insert_at(array, index, value)	\
-	{											\
-		typeof(value) temp = value;				\
-		array = _darray_insert_at(array, index, &temp);	\
-	}
-
-#define darray_pop_at(array, index, value_ptr)	\
-		_darray_pop_at(array, index, value_ptr)
-
-#define darray_clear(array)	\
-		_darray_field_set(array, DARRAY_LENGTH, 0)
-
-#define darray_capacity(array) \
-		_darray_field_get(array, DARRAY_CAPACITY)
-
-#define darray_length(array) \
-		_darray_field_get(array, DARRAY_LENGTH)
-
-#define darray_stride(array) \
-		_darray_field_get(array, DARRAY_STRIDE)
-
-#define darray_length_set(array, value) \
-		_darray_field_set(array, DARRAY_LENGTH, value)
-		
\ No newline at end of file
+#pragma once
+#include <stdint.h>
+
+enum {
+	DARRAY_CAPACITY,
+	DARRAY_LENGTH,
+	DARRAY_STRIDE,
+	DARRAY_ALLOCATOR_TYPE,
+	DARRAY_ALLOCATOR,
+	// Pads the header to 48 bytes so elements start 16 byte aligned.
+	DARRAY_RESERVED,
+	DARRAY_FIELD_LENGTH
+};
+
+typedef enum darray_allocator_type {
+	DARRAY_ALLOCATOR_HEAP,
+	// A linear_allocator. Blocks are reclaimed when it is reset or rolled back.
+	DARRAY_ALLOCATOR_LINEAR,
+	// A frame_allocator. The array lives as long as the frame's memory.
+	DARRAY_ALLOCATOR_FRAME,
+	// A pool_allocator. Arrays that outgrow its largest class move to the heap.
+	DARRAY_ALLOCATOR_POOL
+} darray_allocator_type;
+
+typedef struct darray_allocator {
+	darray_allocator_type type;
+	void* instance;
+} darray_allocator;
+
+#define DARRAY_HEAP ((darray_allocator){DARRAY_ALLOCATOR_HEAP, 0})
+#define DARRAY_LINEAR(linear) ((darray_allocator){DARRAY_ALLOCATOR_LINEAR, (linear)})
+#define DARRAY_FRAME(frame) ((darray_allocator){DARRAY_ALLOCATOR_FRAME, (frame)})
+#define DARRAY_POOL(pool) ((darray_allocator){DARRAY_ALLOCATOR_POOL, (pool)})
+
+void* _darray_create(uint64_t lenght, uint64_t stride);
+// The allocator has to outlive the array. Destroying an arena backed array is
+// optional; it only gives its space back if it is the arena's newest block.
+void* _darray_create_from(uint64_t capacity, uint64_t stride, darray_allocator allocator);
+void  _darray_destroy(void* array);
+
+uint64_t _darray_field_get(void* array, uint64_t field);
+void     _darray_field_set(void* array, uint64_t field, uint64_t value);
+
+static inline uint64_t* _darray_header(const void* array) {
+	return (uint64_t*)array - DARRAY_FIELD_LENGTH;
+}
+
+void* _darray_resize(void* array);
+void* _darray_reserve(void* array, uint64_t capacity);
+void* _darray_shrink_to_fit(void* array);
+
+void* _darray_push(void* array, const void* value_ptr);
+void* _darray_push_n(void* array, const void* values, uint64_t count);
+void  _darray_pop(void* array, void* dest);
+
+void* _darray_pop_at(void* array, uint64_t index, void* dest);
+void* _darray_insert_at(void* array, uint64_t index, void* value_ptr);
+void  _darray_swap_remove(void* array, uint64_t index, void* dest);
+
+// Can be overridden before including this header.
+#ifndef DARRAY_DEFAULT_CAPACITY
+#define DARRAY_DEFAULT_CAPACITY 16
+#endif
+#define DARRAY_RESIZE_FACTOR 2
+
+#define darray_create(type) \
+		_darray_create(DARRAY_DEFAULT_CAPACITY, sizeof(type))
+
+#define darray_create_with_capacity(type, capacity) \
+		_darray_create(capacity, sizeof(type))
+
+#define darray_create_from(type, allocator) \
+		_darray_create_from(DARRAY_DEFAULT_CAPACITY, sizeof(type), allocator)
+
+#define darray_create_with_capacity_from(type, capacity, allocator) \
+		_darray_create_from(capacity, sizeof(type), allocator)
+
+#define darray_destroy(array) _darray_destroy(array);
+
+
+
+#define darray_push(array, value)	\
+	{								\
+		typeof(value) temp = value;				\
+		array = _darray_push(array, &temp); \
+	}
+
+
+// Appends count elements copied from values.
+#define darray_push_n(array, values, count) \
+	{											\
+		array = _darray_push_n(array, values, count);	\
+	}
+
+// Appends every element of another darray with the same stride.
+#define darray_append(array, other) \
+	{											\
+		array = _darray_push_n(array, other, darray_length(other));	\
+	}
+
+// Grows capacity to at least the given element count. Never shrinks.
+#define darray_reserve(array, capacity) \
+	{											\
+		array = _darray_reserve(array, capacity);	\
+	}
+
+#define darray_shrink_to_fit(array) \
+	{											\
+		array = _darray_shrink_to_fit(array);	\
+	}
+
+#define darray_pop(array, value_ptr) \
+		_darray_pop(array, value_ptr)
+
+#define darray_insert_at(array, index, value)	\
+	{											\
+		typeof(value) temp = value;				\
+		array = _darray_insert_at(array, index, &temp);	\
+	}
+
+#define darray_pop_at(array, index, value_ptr)	\
+		_darray_pop_at(array, index, value_ptr)
+
+// Moves the last element into the hole, so it does not keep order. dest may be 0.
+#define darray_swap_remove(array, index, value_ptr)	\
+		_darray_swap_remove(array, index, value_ptr)
+
+#define darray_clear(array)	\
+		(_darray_header(array)[DARRAY_LENGTH] = 0)
+
+#define darray_capacity(array) \
+		(_darray_header(array)[DARRAY_CAPACITY])
+
+#define darray_length(array) \
+		(_darray_header(array)[DARRAY_LENGTH])
+
+#define darray_stride(array) \
+		(_darray_header(array)[DARRAY_STRIDE])
+
+#define darray_length_set(array, value) \
+		(_darray_header(array)[DARRAY_LENGTH] = (value))
+
+// Generates typed inline functions for one element type, e.g.
+// DARRAY_DEFINE(vec3) gives darray_vec3_push(array, value). The element size
+// is a constant, so pushes are plain stores and loops over them can be
+// vectorized. Arrays keep the usual header and work with the macros above.
+// Use DARRAY_DEFINE_NAMED for types that are not a single identifier.
+#define DARRAY_DEFINE(type) DARRAY_DEFINE_NAMED(type, type)
+
+#define DARRAY_DEFINE_NAMED(name, type)																\
+	static inline type* darray_##name##_create(uint64_t capacity) {									\
+		return _darray_create(capacity, sizeof(type));												\
+	}																								\
+	static inline type* darray_##name##_create_from(uint64_t capacity, darray_allocator allocator) {	\
+		return _darray_create_from(capacity, sizeof(type), allocator);								\
+	}																								\
+	static inline uint64_t darray_##name##_length(const type* array) {								\
+		return _darray_header(array)[DARRAY_LENGTH];												\
+	}																								\
+	static inline type* darray_##name##_reserve(type* array, uint64_t capacity) {					\
+		return _darray_reserve(array, capacity);													\
+	}																								\
+	static inline type* darray_##name##_push(type* array, type value) {							\
+		uint64_t* header = _darray_header(array);													\
+		if (header[DARRAY_LENGTH] >= header[DARRAY_CAPACITY]) {										\
+			array = _darray_resize(array);															\
+			header = _darray_header(array);															\
+			if (header[DARRAY_LENGTH] >= header[DARRAY_CAPACITY]) {									\
+				return array;																		\
+			}																						\
+		}																							\
+		array[header[DARRAY_LENGTH]++] = value;														\
+		return array;																				\
+	}																								\
+	static inline type* darray_##name##_push_n(type* array, const type* values, uint64_t count) {	\
+		uint64_t length = _darray_header(array)[DARRAY_LENGTH];										\
+		if (length + count > _darray_header(array)[DARRAY_CAPACITY]) {								\
+			uint64_t capacity = _darray_header(array)[DARRAY_CAPACITY] * DARRAY_RESIZE_FACTOR;		\
+			array = _darray_reserve(array, capacity > length + count ? capacity : length + count);	\
+			if (length + count > _darray_header(array)[DARRAY_CAPACITY]) {							\
+				return array;																		\
+			}																						\
+		}																							\
+		for (uint64_t i = 0; i < count; ++i) {														\
+			array[length + i] = values[i];															\
+		}																							\
+		_darray_header(array)[DARRAY_LENGTH] = length + count;										\
+		return array;																				\
+	}																								\
+	static inline type darray_##name##_pop(type* array) {											\
+		return array[--_darray_header(array)[DARRAY_LENGTH]];										\
+	}																								\
+	static inline type* darray_##name##_get(type* array, uint64_t index) {							\
+		return &array[index];																		\
+	}																								\
+	static inline void darray_##name##_swap_remove(type* array, uint64_t index) {					\
+		array[index] = array[--_darray_header(array)[DARRAY_LENGTH]];								\
+	}
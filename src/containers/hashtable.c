@@ -0,0 +1,410 @@
+#include "hashtable.h"
+
+#include "../core/gmemory.h"
+#include "../core/logger.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HASHTABLE_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define HASHTABLE_EMPTY ((int8_t)-128)
+#define HASHTABLE_DELETED ((int8_t)-2)
+#define HASHTABLE_MIN_CAPACITY HASHTABLE_GROUP_WIDTH
+
+// Slots may be filled up to 7/8 before the table grows.
+static uint64_t hashtable_max_load(uint64_t capacity) {
+	return capacity - capacity / 8;
+}
+
+static uint32_t hashtable_lowest_bit(uint32_t mask) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return index;
+#else
+	return (uint32_t)__builtin_ctz(mask);
+#endif
+}
+
+static uint32_t hashtable_highest_bit(uint32_t mask) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanReverse(&index, mask);
+	return index;
+#else
+	return 31 - (uint32_t)__builtin_clz(mask);
+#endif
+}
+
+// Bit i of the result is set when control byte i of the group matches.
+static uint32_t hashtable_group_match(const int8_t* group, int8_t value) {
+#if HASHTABLE_SSE2
+	__m128i control = _mm_loadu_si128((const __m128i*)group);
+	return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(value)));
+#else
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < HASHTABLE_GROUP_WIDTH; ++i) {
+		mask |= (uint32_t)(group[i] == value) << i;
+	}
+	return mask;
+#endif
+}
+
+static uint32_t hashtable_group_match_free(const int8_t* group) {
+#if HASHTABLE_SSE2
+	// Empty and deleted are the only negative values.
+	__m128i control = _mm_loadu_si128((const __m128i*)group);
+	return (uint32_t)_mm_movemask_epi8(control);
+#else
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < HASHTABLE_GROUP_WIDTH; ++i) {
+		mask |= (uint32_t)(group[i] < 0) << i;
+	}
+	return mask;
+#endif
+}
+
+static uint64_t hashtable_read64(const uint8_t* p) {
+	uint64_t value;
+	memcpy(&value, p, 8);
+	return value;
+}
+
+static uint64_t hashtable_read32(const uint8_t* p) {
+	uint32_t value;
+	memcpy(&value, p, 4);
+	return value;
+}
+
+// 64x64 bit multiply, folded back to 64 bits.
+static uint64_t hashtable_mix(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+	__uint128_t r = (__uint128_t)a * b;
+	return (uint64_t)r ^ (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	uint64_t high;
+	uint64_t low = _umul128(a, b, &high);
+	return low ^ high;
+#else
+	uint64_t ha = a >> 32, la = (uint32_t)a, hb = b >> 32, lb = (uint32_t)b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32);
+	uint64_t carry = t < rl;
+	uint64_t low = t + (rm1 << 32);
+	carry += low < t;
+	uint64_t high = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+	return low ^ high;
+#endif
+}
+
+uint64_t hashtable_hash_bytes(const void* data, uint64_t size, uint64_t seed) {
+	// Multiply-and-fold construction in the style of wyhash.
+	const uint64_t k0 = 0xa0761d6478bd642full;
+	const uint64_t k1 = 0xe7037ed1a0b428dbull;
+	const uint8_t* p = data;
+	uint64_t a = 0;
+	uint64_t b = 0;
+	seed ^= k0;
+
+	if (size <= 16) {
+		if (size >= 8) {
+			a = hashtable_read64(p);
+			b = hashtable_read64(p + size - 8);
+		} else if (size >= 4) {
+			a = hashtable_read32(p);
+			b = hashtable_read32(p + size - 4);
+		} else if (size) {
+			a = ((uint64_t)p[0] << 16) | ((uint64_t)p[size / 2] << 8) | p[size - 1];
+		}
+	} else {
+		uint64_t remaining = size;
+		while (remaining > 16) {
+			seed = hashtable_mix(hashtable_read64(p) ^ k1, hashtable_read64(p + 8) ^ seed);
+			p += 16;
+			remaining -= 16;
+		}
+		a = hashtable_read64(p + remaining - 16);
+		b = hashtable_read64(p + remaining - 8);
+	}
+	return hashtable_mix(k1 ^ size, hashtable_mix(a ^ k1, b ^ seed));
+}
+
+static uint64_t hashtable_hash_default(const void* key, uint64_t key_size) {
+	return hashtable_hash_bytes(key, key_size, 0);
+}
+
+static bool hashtable_equals_default(const void* a, const void* b, uint64_t key_size) {
+	return memcmp(a, b, key_size) == 0;
+}
+
+uint64_t hashtable_hash_string(const void* key, uint64_t key_size) {
+	const char* string = *(const char* const*)key;
+	return hashtable_hash_bytes(string, strlen(string), 0);
+}
+
+bool hashtable_equals_string(const void* a, const void* b, uint64_t key_size) {
+	return strcmp(*(const char* const*)a, *(const char* const*)b) == 0;
+}
+
+static uint64_t hashtable_control_size(uint64_t capacity) {
+	// Rounded so the entries start 16 byte aligned.
+	return (capacity + HASHTABLE_GROUP_WIDTH + 15) & ~(uint64_t)15;
+}
+
+static uint64_t hashtable_block_size(uint64_t capacity, uint64_t entry_size) {
+	return hashtable_control_size(capacity) + capacity * entry_size;
+}
+
+// Smallest power of two capacity that holds count entries under the load limit.
+static uint64_t hashtable_capacity_for(uint64_t count) {
+	uint64_t capacity = HASHTABLE_MIN_CAPACITY;
+	while (hashtable_max_load(capacity) < count) {
+		capacity <<= 1;
+	}
+	return capacity;
+}
+
+static uint8_t* hashtable_entry(const hashtable* table, uint64_t index) {
+	return table->entries + index * table->entry_size;
+}
+
+static void hashtable_set_control(hashtable* table, uint64_t index, int8_t value) {
+	table->control[index] = value;
+	if (index < HASHTABLE_GROUP_WIDTH) {
+		table->control[table->capacity + index] = value;
+	}
+}
+
+// The low 7 bits of the hash go into the control byte, the rest pick the start.
+static int8_t hashtable_h2(uint64_t hash) {
+	return (int8_t)(hash & 0x7F);
+}
+
+static int64_t hashtable_find_index(const hashtable* table, const void* key, uint64_t hash) {
+	uint64_t mask = table->capacity - 1;
+	int8_t h2 = hashtable_h2(hash);
+	uint64_t position = (hash >> 7) & mask;
+	for (uint64_t step = 0;;) {
+		const int8_t* group = table->control + position;
+		for (uint32_t match = hashtable_group_match(group, h2); match; match &= match - 1) {
+			uint64_t index = (position + hashtable_lowest_bit(match)) & mask;
+			if (table->equals(hashtable_entry(table, index), key, table->key_size)) {
+				return (int64_t)index;
+			}
+		}
+		// Probing stops at the first group with an empty slot.
+		if (hashtable_group_match(group, HASHTABLE_EMPTY)) {
+			return -1;
+		}
+		step += HASHTABLE_GROUP_WIDTH;
+		position = (position + step) & mask;
+	}
+}
+
+static uint64_t hashtable_find_free_index(const hashtable* table, uint64_t hash) {
+	uint64_t mask = table->capacity - 1;
+	uint64_t position = (hash >> 7) & mask;
+	for (uint64_t step = 0;;) {
+		uint32_t match = hashtable_group_match_free(table->control + position);
+		if (match) {
+			return (position + hashtable_lowest_bit(match)) & mask;
+		}
+		step += HASHTABLE_GROUP_WIDTH;
+		position = (position + step) & mask;
+	}
+}
+
+static bool hashtable_allocate(hashtable* table, uint64_t capacity) {
+	uint8_t* block = gallocate_flags(hashtable_block_size(capacity, table->entry_size), MEMORY_TAG_DICT, MEMORY_FLAG_NO_ZERO | MEMORY_FLAG_ALIGN_16);
+	if (!block) {
+		return false;
+	}
+
+	table->capacity = capacity;
+	table->count = 0;
+	table->growth_left = hashtable_max_load(capacity);
+	table->control = (int8_t*)block;
+	table->entries = block + hashtable_control_size(capacity);
+	gset_memory(table->control, HASHTABLE_EMPTY, capacity + HASHTABLE_GROUP_WIDTH);
+	return true;
+}
+
+static void hashtable_free_block(int8_t* control, uint64_t capacity, uint64_t entry_size) {
+	gfree_flags(control, hashtable_block_size(capacity, entry_size), MEMORY_TAG_DICT, MEMORY_FLAG_ALIGN_16);
+}
+
+static bool hashtable_resize(hashtable* table, uint64_t capacity) {
+	int8_t* old_control = table->control;
+	uint8_t* old_entries = table->entries;
+	uint64_t old_capacity = table->capacity;
+	uint64_t count = table->count;
+	if (!hashtable_allocate(table, capacity)) {
+		table->control = old_control;
+		table->entries = old_entries;
+		KERROR("hashtable_resize - failed to allocate %llu slots.", capacity);
+		return false;
+	}
+
+	// Keys are known to be unique, so entries go straight to a free slot.
+	for (uint64_t i = 0; i < old_capacity; ++i) {
+		if (old_control[i] < 0) {
+			continue;
+		}
+		uint8_t* entry = old_entries + i * table->entry_size;
+		uint64_t hash = table->hash(entry, table->key_size);
+		uint64_t index = hashtable_find_free_index(table, hash);
+		hashtable_set_control(table, index, hashtable_h2(hash));
+		gcopy_memory(hashtable_entry(table, index), entry, table->entry_size);
+	}
+	table->count = count;
+	table->growth_left -= count;
+
+	hashtable_free_block(old_control, old_capacity, table->entry_size);
+	return true;
+}
+
+bool hashtable_create(uint64_t key_size, uint64_t value_size, uint64_t capacity, hashtable* out_table) {
+	return hashtable_create_custom(key_size, value_size, capacity, 0, 0, out_table);
+}
+
+bool hashtable_create_custom(uint64_t key_size, uint64_t value_size, uint64_t capacity,
+	pfn_hashtable_hash hash, pfn_hashtable_equals equals, hashtable* out_table) {
+	if (!out_table || key_size == 0) {
+		KERROR("hashtable_create - requires a table and a non-zero key size.");
+		return false;
+	}
+
+	gzero_memory(out_table, sizeof(hashtable));
+	out_table->key_size = key_size;
+	out_table->value_size = value_size;
+	out_table->value_offset = (key_size + 7) & ~(uint64_t)7;
+	out_table->entry_size = (out_table->value_offset + value_size + 7) & ~(uint64_t)7;
+	out_table->hash = hash ? hash : hashtable_hash_default;
+	out_table->equals = equals ? equals : hashtable_equals_default;
+	return hashtable_allocate(out_table, hashtable_capacity_for(capacity));
+}
+
+void hashtable_destroy(hashtable* table) {
+	if (table && table->control) {
+		hashtable_free_block(table->control, table->capacity, table->entry_size);
+		gzero_memory(table, sizeof(hashtable));
+	}
+}
+
+void* hashtable_find(const hashtable* table, const void* key) {
+	int64_t index = hashtable_find_index(table, key, table->hash(key, table->key_size));
+	return index < 0 ? 0 : hashtable_entry(table, (uint64_t)index) + table->value_offset;
+}
+
+bool hashtable_contains(const hashtable* table, const void* key) {
+	return hashtable_find(table, key) != 0;
+}
+
+void* hashtable_emplace(hashtable* table, const void* key, bool* out_inserted) {
+	uint64_t hash = table->hash(key, table->key_size);
+	int64_t found = hashtable_find_index(table, key, hash);
+	if (out_inserted) {
+		*out_inserted = found < 0;
+	}
+	if (found >= 0) {
+		return hashtable_entry(table, (uint64_t)found) + table->value_offset;
+	}
+
+	uint64_t index = hashtable_find_free_index(table, hash);
+	if (table->growth_left == 0 && table->control[index] == HASHTABLE_EMPTY) {
+		// Mostly tombstones: clean up in place rather than doubling.
+		uint64_t capacity = table->count < hashtable_max_load(table->capacity) / 2 ? table->capacity : table->capacity * 2;
+		if (!hashtable_resize(table, capacity)) {
+			return 0;
+		}
+		index = hashtable_find_free_index(table, hash);
+	}
+
+	if (table->control[index] == HASHTABLE_EMPTY) {
+		table->growth_left--;
+	}
+	hashtable_set_control(table, index, hashtable_h2(hash));
+	table->count++;
+
+	uint8_t* entry = hashtable_entry(table, index);
+	gcopy_memory(entry, key, table->key_size);
+	gzero_memory(entry + table->value_offset, table->value_size);
+	return entry + table->value_offset;
+}
+
+bool hashtable_set(hashtable* table, const void* key, const void* value) {
+	void* slot = hashtable_emplace(table, key, 0);
+	if (!slot) {
+		return false;
+	}
+	gcopy_memory(slot, value, table->value_size);
+	return true;
+}
+
+bool hashtable_remove(hashtable* table, const void* key, void* out_value) {
+	int64_t found = hashtable_find_index(table, key, table->hash(key, table->key_size));
+	if (found < 0) {
+		return false;
+	}
+
+	uint64_t index = (uint64_t)found;
+	if (out_value) {
+		gcopy_memory(out_value, hashtable_entry(table, index) + table->value_offset, table->value_size);
+	}
+
+	// A slot can go back to empty when no group containing it was ever full,
+	// since then no probe has passed over it. Otherwise leave a tombstone.
+	uint64_t mask = table->capacity - 1;
+	uint32_t empty_after = hashtable_group_match(table->control + index, HASHTABLE_EMPTY);
+	uint32_t empty_before = hashtable_group_match(table->control + ((index - HASHTABLE_GROUP_WIDTH) & mask), HASHTABLE_EMPTY);
+	bool was_never_full = empty_before && empty_after &&
+		hashtable_lowest_bit(empty_after) + (HASHTABLE_GROUP_WIDTH - 1 - hashtable_highest_bit(empty_before)) < HASHTABLE_GROUP_WIDTH;
+	if (was_never_full) {
+		hashtable_set_control(table, index, HASHTABLE_EMPTY);
+		table->growth_left++;
+	} else {
+		hashtable_set_control(table, index, HASHTABLE_DELETED);
+	}
+	table->count--;
+	return true;
+}
+
+void hashtable_clear(hashtable* table) {
+	gset_memory(table->control, HASHTABLE_EMPTY, table->capacity + HASHTABLE_GROUP_WIDTH);
+	table->count = 0;
+	table->growth_left = hashtable_max_load(table->capacity);
+}
+
+bool hashtable_reserve(hashtable* table, uint64_t count) {
+	uint64_t capacity = hashtable_capacity_for(count);
+	if (capacity <= table->capacity) {
+		return true;
+	}
+	return hashtable_resize(table, capacity);
+}
+
+bool hashtable_rehash(hashtable* table, uint64_t count) {
+	return hashtable_resize(table, hashtable_capacity_for(count > table->count ? count : table->count));
+}
+
+bool hashtable_next(const hashtable* table, uint64_t* iterator, void** out_key, void** out_value) {
+	for (uint64_t i = *iterator; i < table->capacity; ++i) {
+		if (table->control[i] >= 0) {
+			uint8_t* entry = hashtable_entry(table, i);
+			if (out_key) {
+				*out_key = entry;
+			}
+			if (out_value) {
+				*out_value = entry + table->value_offset;
+			}
+			*iterator = i + 1;
+			return true;
+		}
+	}
+	*iterator = table->capacity;
+	return false;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Open-addressed hash table in the Swiss table layout: one control byte per
+// slot holds 7 bits of the hash, and 16 of them are matched at once with SSE2,
+// so a lookup usually touches one control group and one entry.
+// Keys and values are copied in by value. Entry pointers stay valid until the
+// next insert that grows or rehashes the table.
+
+#define HASHTABLE_GROUP_WIDTH 16
+
+typedef uint64_t (*pfn_hashtable_hash)(const void* key, uint64_t key_size);
+typedef bool (*pfn_hashtable_equals)(const void* a, const void* b, uint64_t key_size);
+
+typedef struct hashtable {
+	uint64_t key_size;
+	uint64_t value_size;
+	// Offset of the value inside an entry, and the size of one entry.
+	uint64_t value_offset;
+	uint64_t entry_size;
+
+	// Slot count, a power of two.
+	uint64_t capacity;
+	uint64_t count;
+	// Inserts left before the table has to grow or drop its tombstones.
+	uint64_t growth_left;
+
+	// capacity control bytes, followed by a copy of the first group so a group
+	// can be loaded at any slot without wrapping.
+	int8_t* control;
+	uint8_t* entries;
+
+	pfn_hashtable_hash hash;
+	pfn_hashtable_equals equals;
+} hashtable;
+
+// Fast 64-bit hash of arbitrary bytes.
+uint64_t hashtable_hash_bytes(const void* data, uint64_t size, uint64_t seed);
+
+// For tables keyed by null terminated "const char*". key_size is sizeof(char*).
+uint64_t hashtable_hash_string(const void* key, uint64_t key_size);
+bool hashtable_equals_string(const void* a, const void* b, uint64_t key_size);
+
+// capacity is the number of entries to hold without growing. Keys are hashed
+// and compared as raw bytes, so struct keys must not contain padding.
+bool hashtable_create(uint64_t key_size, uint64_t value_size, uint64_t capacity, hashtable* out_table);
+bool hashtable_create_custom(uint64_t key_size, uint64_t value_size, uint64_t capacity,
+	pfn_hashtable_hash hash, pfn_hashtable_equals equals, hashtable* out_table);
+void hashtable_destroy(hashtable* table);
+
+// Returns the value stored for key, or 0.
+void* hashtable_find(const hashtable* table, const void* key);
+bool hashtable_contains(const hashtable* table, const void* key);
+
+// Returns the value slot for key, inserting it when missing. A new slot's
+// value is zeroed. Returns 0 only when the table fails to grow.
+void* hashtable_emplace(hashtable* table, const void* key, bool* out_inserted);
+// Inserts or overwrites.
+bool hashtable_set(hashtable* table, const void* key, const void* value);
+// Copies the removed value to out_value when it is not 0.
+bool hashtable_remove(hashtable* table, const void* key, void* out_value);
+void hashtable_clear(hashtable* table);
+
+// Grows so count entries fit without another rehash.
+bool hashtable_reserve(hashtable* table, uint64_t count);
+// Rebuilds at the smallest capacity that holds max(count, current count)
+// entries, dropping tombstones. Also used to shrink.
+bool hashtable_rehash(hashtable* table, uint64_t count);
+
+// Walks the entries in slot order. Start with *iterator = 0. Inserting or
+// removing during the walk is not allowed, except removing the current entry.
+bool hashtable_next(const hashtable* table, uint64_t* iterator, void** out_key, void** out_value);
+
+// Generates typed inline wrappers, e.g. HASHTABLE_DEFINE(texture_ids, uint64_t, uint32_t)
+// gives hashtable_texture_ids_set(table, key, value) and friends.
+#define HASHTABLE_DEFINE(name, key_type, value_type)											\
+	static inline bool hashtable_##name##_create(uint64_t capacity, hashtable* out_table) {		\
+		return hashtable_create(sizeof(key_type), sizeof(value_type), capacity, out_table);		\
+	}																							\
+	static inline value_type* hashtable_##name##_find(const hashtable* table, key_type key) {	\
+		return (value_type*)hashtable_find(table, &key);										\
+	}																							\
+	static inline bool hashtable_##name##_set(hashtable* table, key_type key, value_type value) {	\
+		return hashtable_set(table, &key, &value);												\
+	}																							\
+	static inline bool hashtable_##name##_remove(hashtable* table, key_type key) {				\
+		return hashtable_remove(table, &key, 0);												\
+	}
@@ -0,0 +1,156 @@
+#include "ring_queue.h"
+
+#include "../core/gmemory.h"
+#include "../core/logger.h"
+#include "../platform/platform.h"
+
+static uint64_t ring_queue_capacity(uint64_t capacity) {
+	uint64_t rounded = 2;
+	while (rounded < capacity) {
+		rounded <<= 1;
+	}
+	return rounded;
+}
+
+bool spsc_queue_create(uint64_t element_size, uint64_t capacity, spsc_queue* out_queue) {
+	if (!out_queue || element_size == 0) {
+		KERROR("spsc_queue_create - requires a queue and a non-zero element size.");
+		return false;
+	}
+
+	gzero_memory(out_queue, sizeof(spsc_queue));
+	capacity = ring_queue_capacity(capacity);
+	out_queue->element_size = element_size;
+	out_queue->mask = capacity - 1;
+	out_queue->buffer = gallocate_flags(capacity * element_size, MEMORY_TAG_RING_QUEUE, MEMORY_FLAG_NO_ZERO | MEMORY_FLAG_ALIGN_64);
+	return out_queue->buffer != 0;
+}
+
+void spsc_queue_destroy(spsc_queue* queue) {
+	if (queue && queue->buffer) {
+		gfree_flags(queue->buffer, (queue->mask + 1) * queue->element_size, MEMORY_TAG_RING_QUEUE, MEMORY_FLAG_ALIGN_64);
+		gzero_memory(queue, sizeof(spsc_queue));
+	}
+}
+
+bool spsc_queue_push(spsc_queue* queue, const void* element) {
+	int64_t tail = platform_atomic_load_relaxed_i64(&queue->tail);
+	if (tail - queue->cached_head > (int64_t)queue->mask) {
+		// Looks full; only now pay for reading the consumer's line.
+		queue->cached_head = platform_atomic_load_acquire_i64(&queue->head);
+		if (tail - queue->cached_head > (int64_t)queue->mask) {
+			return false;
+		}
+	}
+
+	gcopy_memory(queue->buffer + ((uint64_t)tail & queue->mask) * queue->element_size, element, queue->element_size);
+	platform_atomic_store_release_i64(&queue->tail, tail + 1);
+	return true;
+}
+
+bool spsc_queue_pop(spsc_queue* queue, void* out_element) {
+	int64_t head = platform_atomic_load_relaxed_i64(&queue->head);
+	if (head == queue->cached_tail) {
+		queue->cached_tail = platform_atomic_load_acquire_i64(&queue->tail);
+		if (head == queue->cached_tail) {
+			return false;
+		}
+	}
+
+	gcopy_memory(out_element, queue->buffer + ((uint64_t)head & queue->mask) * queue->element_size, queue->element_size);
+	platform_atomic_store_release_i64(&queue->head, head + 1);
+	return true;
+}
+
+uint64_t spsc_queue_count(spsc_queue* queue) {
+	int64_t head = platform_atomic_load_acquire_i64(&queue->head);
+	int64_t tail = platform_atomic_load_acquire_i64(&queue->tail);
+	return tail > head ? (uint64_t)(tail - head) : 0;
+}
+
+static volatile int64_t* mpmc_queue_sequence(mpmc_queue* queue, int64_t position) {
+	return (volatile int64_t*)(queue->cells + ((uint64_t)position & queue->mask) * queue->cell_size);
+}
+
+bool mpmc_queue_create(uint64_t element_size, uint64_t capacity, mpmc_queue* out_queue) {
+	if (!out_queue || element_size == 0) {
+		KERROR("mpmc_queue_create - requires a queue and a non-zero element size.");
+		return false;
+	}
+
+	gzero_memory(out_queue, sizeof(mpmc_queue));
+	capacity = ring_queue_capacity(capacity);
+	out_queue->element_size = element_size;
+	out_queue->cell_size = sizeof(int64_t) + ((element_size + 7) & ~(uint64_t)7);
+	out_queue->mask = capacity - 1;
+	out_queue->cells = gallocate_flags(capacity * out_queue->cell_size, MEMORY_TAG_RING_QUEUE, MEMORY_FLAG_NO_ZERO | MEMORY_FLAG_ALIGN_64);
+	if (!out_queue->cells) {
+		return false;
+	}
+
+	// A cell is free for the producer at position p when its sequence is p.
+	for (uint64_t i = 0; i < capacity; ++i) {
+		platform_atomic_store_relaxed_i64(mpmc_queue_sequence(out_queue, (int64_t)i), (int64_t)i);
+	}
+	return true;
+}
+
+void mpmc_queue_destroy(mpmc_queue* queue) {
+	if (queue && queue->cells) {
+		gfree_flags(queue->cells, (queue->mask + 1) * queue->cell_size, MEMORY_TAG_RING_QUEUE, MEMORY_FLAG_ALIGN_64);
+		gzero_memory(queue, sizeof(mpmc_queue));
+	}
+}
+
+bool mpmc_queue_push(mpmc_queue* queue, const void* element) {
+	int64_t position = platform_atomic_load_relaxed_i64(&queue->enqueue_position);
+	volatile int64_t* sequence;
+	for (;;) {
+		sequence = mpmc_queue_sequence(queue, position);
+		int64_t difference = platform_atomic_load_acquire_i64(sequence) - position;
+		if (difference == 0) {
+			// On failure position is reloaded with the current value.
+			if (platform_atomic_compare_exchange_i64(&queue->enqueue_position, &position, position + 1)) {
+				break;
+			}
+		} else if (difference < 0) {
+			// The consumer has not released this cell from the previous lap.
+			return false;
+		} else {
+			position = platform_atomic_load_relaxed_i64(&queue->enqueue_position);
+		}
+	}
+
+	gcopy_memory((uint8_t*)sequence + sizeof(int64_t), element, queue->element_size);
+	platform_atomic_store_release_i64(sequence, position + 1);
+	return true;
+}
+
+bool mpmc_queue_pop(mpmc_queue* queue, void* out_element) {
+	int64_t position = platform_atomic_load_relaxed_i64(&queue->dequeue_position);
+	volatile int64_t* sequence;
+	for (;;) {
+		sequence = mpmc_queue_sequence(queue, position);
+		int64_t difference = platform_atomic_load_acquire_i64(sequence) - (position + 1);
+		if (difference == 0) {
+			if (platform_atomic_compare_exchange_i64(&queue->dequeue_position, &position, position + 1)) {
+				break;
+			}
+		} else if (difference < 0) {
+			return false;
+		} else {
+			position = platform_atomic_load_relaxed_i64(&queue->dequeue_position);
+		}
+	}
+
+	gcopy_memory(out_element, (uint8_t*)sequence + sizeof(int64_t), queue->element_size);
+	// Hand the cell to the producer one lap ahead.
+	platform_atomic_store_release_i64(sequence, position + (int64_t)queue->mask + 1);
+	return true;
+}
+
+uint64_t mpmc_queue_count(mpmc_queue* queue) {
+	int64_t dequeue = platform_atomic_load_acquire_i64(&queue->dequeue_position);
+	int64_t enqueue = platform_atomic_load_acquire_i64(&queue->enqueue_position);
+	return enqueue > dequeue ? (uint64_t)(enqueue - dequeue) : 0;
+}
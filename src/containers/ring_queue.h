@@ -0,0 +1,64 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Fixed capacity ring buffers for handing elements between threads without
+// locks. Capacities are rounded up to a power of two and elements are copied
+// in and out by value. The index each side writes sits on its own cache line.
+
+#define RING_QUEUE_CACHE_LINE 64
+
+// Single producer, single consumer. Push and pop are wait-free: each side
+// owns one index and only reads the other's, caching it until it runs out.
+typedef struct spsc_queue {
+	uint64_t element_size;
+	uint64_t mask;
+	uint8_t* buffer;
+	uint8_t pad0[RING_QUEUE_CACHE_LINE - 3 * sizeof(uint64_t)];
+
+	// Written by the producer.
+	volatile int64_t tail;
+	int64_t cached_head;
+	uint8_t pad1[RING_QUEUE_CACHE_LINE - 2 * sizeof(int64_t)];
+
+	// Written by the consumer.
+	volatile int64_t head;
+	int64_t cached_tail;
+	uint8_t pad2[RING_QUEUE_CACHE_LINE - 2 * sizeof(int64_t)];
+} spsc_queue;
+
+bool spsc_queue_create(uint64_t element_size, uint64_t capacity, spsc_queue* out_queue);
+void spsc_queue_destroy(spsc_queue* queue);
+// Producer side. Returns false when the queue is full.
+bool spsc_queue_push(spsc_queue* queue, const void* element);
+// Consumer side. Returns false when the queue is empty.
+bool spsc_queue_pop(spsc_queue* queue, void* out_element);
+// Only exact when both sides are idle.
+uint64_t spsc_queue_count(spsc_queue* queue);
+
+// Bounded multi producer, multi consumer queue. Every cell carries a sequence
+// number that tells producers and consumers whose turn it is, so threads only
+// contend on the index they advance.
+typedef struct mpmc_queue {
+	uint64_t element_size;
+	// Sequence number plus the element, rounded to 8 bytes.
+	uint64_t cell_size;
+	uint64_t mask;
+	uint8_t* cells;
+	uint8_t pad0[RING_QUEUE_CACHE_LINE - 4 * sizeof(uint64_t)];
+
+	volatile int64_t enqueue_position;
+	uint8_t pad1[RING_QUEUE_CACHE_LINE - sizeof(int64_t)];
+
+	volatile int64_t dequeue_position;
+	uint8_t pad2[RING_QUEUE_CACHE_LINE - sizeof(int64_t)];
+} mpmc_queue;
+
+bool mpmc_queue_create(uint64_t element_size, uint64_t capacity, mpmc_queue* out_queue);
+void mpmc_queue_destroy(mpmc_queue* queue);
+// Returns false when the queue is full.
+bool mpmc_queue_push(mpmc_queue* queue, const void* element);
+// Returns false when the queue is empty.
+bool mpmc_queue_pop(mpmc_queue* queue, void* out_element);
+// Only exact when no push or pop is in progress.
+uint64_t mpmc_queue_count(mpmc_queue* queue);
@@ -0,0 +1,182 @@
+#include "slot_map.h"
+
+#include "darray.h"
+#include "../core/gmemory.h"
+#include "../core/logger.h"
+
+#define SLOT_MAP_NO_FREE_SLOT UINT32_MAX
+
+typedef struct slot_map_slot {
+	// Dense index while the slot is occupied, next free slot while it is not.
+	uint32_t link;
+	uint32_t generation;
+} slot_map_slot;
+
+DARRAY_DEFINE(slot_map_slot);
+DARRAY_DEFINE_NAMED(slot_index, uint32_t);
+
+// Sits right before the dense elements. A multiple of 16 bytes so the
+// elements stay aligned.
+typedef struct slot_map_header {
+	uint64_t capacity;
+	uint64_t length;
+	uint64_t stride;
+	slot_map_slot* slots;
+	// Slot owning each dense element.
+	uint32_t* dense_to_slot;
+	uint32_t free_head;
+	uint32_t reserved;
+} slot_map_header;
+
+static slot_map_header* slot_map_get_header(void* map) {
+	return (slot_map_header*)map - 1;
+}
+
+void* _slot_map_create(uint64_t capacity, uint64_t stride) {
+	slot_map_header* header = gallocate_flags(sizeof(slot_map_header) + capacity * stride, MEMORY_TAG_ARRAY, MEMORY_FLAG_NO_ZERO);
+	if (!header) {
+		KERROR("slot_map_create - failed to allocate %llu elements of %lluB.", capacity, stride);
+		return 0;
+	}
+
+	header->capacity = capacity;
+	header->length = 0;
+	header->stride = stride;
+	header->slots = darray_slot_map_slot_create(capacity);
+	header->dense_to_slot = darray_slot_index_create(capacity);
+	header->free_head = SLOT_MAP_NO_FREE_SLOT;
+	header->reserved = 0;
+	return header + 1;
+}
+
+void _slot_map_destroy(void* map) {
+	slot_map_header* header = slot_map_get_header(map);
+	darray_destroy(header->slots);
+	darray_destroy(header->dense_to_slot);
+	gfree(header, sizeof(slot_map_header) + header->capacity * header->stride, MEMORY_TAG_ARRAY);
+}
+
+void* _slot_map_reserve(void* map, uint64_t capacity) {
+	slot_map_header* header = slot_map_get_header(map);
+	if (capacity <= header->capacity) {
+		return map;
+	}
+
+	slot_map_header* new_header = greallocate_flags(
+		header,
+		sizeof(slot_map_header) + header->capacity * header->stride,
+		sizeof(slot_map_header) + capacity * header->stride,
+		MEMORY_TAG_ARRAY,
+		MEMORY_FLAG_NO_ZERO);
+	if (!new_header) {
+		return map;
+	}
+
+	new_header->capacity = capacity;
+	new_header->dense_to_slot = darray_slot_index_reserve(new_header->dense_to_slot, capacity);
+	return new_header + 1;
+}
+
+void* _slot_map_insert(void* map, const void* value_ptr, slot_handle* out_handle) {
+	slot_map_header* header = slot_map_get_header(map);
+	if (header->length >= header->capacity) {
+		map = _slot_map_reserve(map, header->capacity ? header->capacity * 2 : SLOT_MAP_DEFAULT_CAPACITY);
+		header = slot_map_get_header(map);
+		if (header->length >= header->capacity) {
+			if (out_handle) {
+				*out_handle = SLOT_HANDLE_INVALID;
+			}
+			return map;
+		}
+	}
+
+	uint32_t index = header->free_head;
+	if (index != SLOT_MAP_NO_FREE_SLOT) {
+		header->free_head = header->slots[index].link;
+	} else {
+		index = (uint32_t)darray_length(header->slots);
+		slot_map_slot slot = {0, 1};
+		header->slots = darray_slot_map_slot_push(header->slots, slot);
+	}
+
+	uint32_t dense_index = (uint32_t)header->length;
+	header->slots[index].link = dense_index;
+	header->dense_to_slot = darray_slot_index_push(header->dense_to_slot, index);
+	gcopy_memory((uint8_t*)map + dense_index * header->stride, value_ptr, header->stride);
+	header->length++;
+
+	if (out_handle) {
+		out_handle->index = index;
+		out_handle->generation = header->slots[index].generation;
+	}
+	return map;
+}
+
+void* _slot_map_get(void* map, slot_handle handle) {
+	slot_map_header* header = slot_map_get_header(map);
+	// A free slot's generation has already moved past every handle issued
+	// for it, so a matching generation means the slot is occupied.
+	if (handle.index >= darray_length(header->slots) || header->slots[handle.index].generation != handle.generation) {
+		return 0;
+	}
+	return (uint8_t*)map + header->slots[handle.index].link * header->stride;
+}
+
+bool _slot_map_remove(void* map, slot_handle handle, void* dest) {
+	uint8_t* element = _slot_map_get(map, handle);
+	if (!element) {
+		return false;
+	}
+
+	slot_map_header* header = slot_map_get_header(map);
+	slot_map_slot* slot = &header->slots[handle.index];
+	uint32_t dense_index = slot->link;
+	uint32_t last = (uint32_t)header->length - 1;
+	if (dest) {
+		gcopy_memory(dest, element, header->stride);
+	}
+
+	// Keep the elements packed by moving the last one into the hole.
+	if (dense_index != last) {
+		gcopy_memory(element, (uint8_t*)map + last * header->stride, header->stride);
+		uint32_t moved_slot = header->dense_to_slot[last];
+		header->slots[moved_slot].link = dense_index;
+		header->dense_to_slot[dense_index] = moved_slot;
+	}
+	darray_length_set(header->dense_to_slot, last);
+	header->length = last;
+
+	slot->generation = slot->generation + 1 ? slot->generation + 1 : 1;
+	slot->link = header->free_head;
+	header->free_head = handle.index;
+	return true;
+}
+
+void _slot_map_clear(void* map) {
+	slot_map_header* header = slot_map_get_header(map);
+	for (uint64_t i = 0; i < header->length; ++i) {
+		uint32_t index = header->dense_to_slot[i];
+		slot_map_slot* slot = &header->slots[index];
+		slot->generation = slot->generation + 1 ? slot->generation + 1 : 1;
+		slot->link = header->free_head;
+		header->free_head = index;
+	}
+	darray_clear(header->dense_to_slot);
+	header->length = 0;
+}
+
+uint64_t _slot_map_length(void* map) {
+	return slot_map_get_header(map)->length;
+}
+
+slot_handle _slot_map_handle_at(void* map, uint64_t dense_index) {
+	slot_map_header* header = slot_map_get_header(map);
+	if (dense_index >= header->length) {
+		return SLOT_HANDLE_INVALID;
+	}
+
+	slot_handle handle;
+	handle.index = header->dense_to_slot[dense_index];
+	handle.generation = header->slots[handle.index].generation;
+	return handle;
+}
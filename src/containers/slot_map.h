@@ -0,0 +1,72 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Stable handles to densely packed elements. Like a darray, the map is the
+// element array itself, so live elements can be walked directly with
+// map[0] .. map[slot_map_length(map) - 1]. Removing an element moves the last
+// one into its place; handles keep working, raw pointers and indices do not.
+// A handle stops resolving once its element is removed, even if the slot is
+// reused, because every removal bumps the slot's generation.
+
+typedef struct slot_handle {
+	uint32_t index;
+	uint32_t generation;
+} slot_handle;
+
+// Generations start at 1, so a zeroed handle never resolves.
+#define SLOT_HANDLE_INVALID ((slot_handle){0, 0})
+
+#define SLOT_MAP_DEFAULT_CAPACITY 16
+
+void* _slot_map_create(uint64_t capacity, uint64_t stride);
+void  _slot_map_destroy(void* map);
+
+void* _slot_map_reserve(void* map, uint64_t capacity);
+void* _slot_map_insert(void* map, const void* value_ptr, slot_handle* out_handle);
+// Returns the element, or 0 when the handle is stale.
+void* _slot_map_get(void* map, slot_handle handle);
+// Copies the removed element to dest when it is not 0.
+bool  _slot_map_remove(void* map, slot_handle handle, void* dest);
+void  _slot_map_clear(void* map);
+
+uint64_t    _slot_map_length(void* map);
+// Handle of the element at a dense index, for walking the map.
+slot_handle _slot_map_handle_at(void* map, uint64_t dense_index);
+
+#define slot_map_create(type) \
+		_slot_map_create(SLOT_MAP_DEFAULT_CAPACITY, sizeof(type))
+
+#define slot_map_create_with_capacity(type, capacity) \
+		_slot_map_create(capacity, sizeof(type))
+
+#define slot_map_destroy(map) _slot_map_destroy(map);
+
+#define slot_map_reserve(map, capacity) \
+	{											\
+		map = _slot_map_reserve(map, capacity);	\
+	}
+
+#define slot_map_insert(map, value, out_handle)	\
+	{											\
+		typeof(value) temp = value;				\
+		map = _slot_map_insert(map, &temp, out_handle);	\
+	}
+
+#define slot_map_get(map, handle) \
+		((typeof(map))_slot_map_get(map, handle))
+
+#define slot_map_contains(map, handle) \
+		(_slot_map_get(map, handle) != 0)
+
+#define slot_map_remove(map, handle, value_ptr) \
+		_slot_map_remove(map, handle, value_ptr)
+
+#define slot_map_clear(map) \
+		_slot_map_clear(map)
+
+#define slot_map_length(map) \
+		_slot_map_length(map)
+
+#define slot_map_handle_at(map, dense_index) \
+		_slot_map_handle_at(map, dense_index)
@@ -0,0 +1,96 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "darray.h"
+
+// Array with room for a few elements inside the struct itself, for lists that
+// are almost always short. Nothing is allocated until it outgrows the inline
+// storage; the elements then move to a darray from the vector's allocator
+// and stay there. The struct holds no pointer into itself, so it can be
+// copied or moved while it is inline.
+//
+// SMALL_VECTOR_DEFINE(names, const char*, 4) declares small_vector_names and
+// small_vector_names_push(&vector, value) and friends.
+#define SMALL_VECTOR_DEFINE(name, type, inline_capacity)												\
+	typedef struct small_vector_##name {																\
+		uint64_t length;																				\
+		darray_allocator allocator;																		\
+		/* The darray holding the elements once they spilled, 0 while inline. */					\
+		type* spilled;																					\
+		type inline_data[inline_capacity];																\
+	} small_vector_##name;																				\
+																										\
+	static inline void small_vector_##name##_init(small_vector_##name* vector, darray_allocator allocator) {	\
+		vector->length = 0;																				\
+		vector->allocator = allocator;																	\
+		vector->spilled = 0;																			\
+	}																									\
+	static inline void small_vector_##name##_destroy(small_vector_##name* vector) {						\
+		if (vector->spilled) {																			\
+			_darray_destroy(vector->spilled);															\
+			vector->spilled = 0;																		\
+		}																								\
+		vector->length = 0;																				\
+	}																									\
+	static inline type* small_vector_##name##_data(const small_vector_##name* vector) {				\
+		return vector->spilled ? vector->spilled : (type*)vector->inline_data;							\
+	}																									\
+	static inline uint64_t* small_vector_##name##_length_ptr(small_vector_##name* vector) {			\
+		return vector->spilled ? &_darray_header(vector->spilled)[DARRAY_LENGTH] : &vector->length;	\
+	}																									\
+	static inline uint64_t small_vector_##name##_length(const small_vector_##name* vector) {			\
+		return vector->spilled ? _darray_header(vector->spilled)[DARRAY_LENGTH] : vector->length;		\
+	}																									\
+	static inline bool small_vector_##name##_is_inline(const small_vector_##name* vector) {			\
+		return vector->spilled == 0;																	\
+	}																									\
+	/* Returns false only when spilling or growing fails. */											\
+	static inline bool small_vector_##name##_push(small_vector_##name* vector, type value) {			\
+		if (!vector->spilled) {																			\
+			if (vector->length < (inline_capacity)) {													\
+				vector->inline_data[vector->length++] = value;											\
+				return true;																			\
+			}																							\
+			type* spilled = _darray_create_from((inline_capacity) * 2, sizeof(type), vector->allocator);	\
+			if (!spilled) {																				\
+				return false;																			\
+			}																							\
+			for (uint64_t i = 0; i < vector->length; ++i) {												\
+				spilled[i] = vector->inline_data[i];													\
+			}																							\
+			_darray_header(spilled)[DARRAY_LENGTH] = vector->length;									\
+			vector->spilled = spilled;																	\
+		}																								\
+		uint64_t* header = _darray_header(vector->spilled);												\
+		if (header[DARRAY_LENGTH] >= header[DARRAY_CAPACITY]) {											\
+			vector->spilled = _darray_resize(vector->spilled);											\
+			header = _darray_header(vector->spilled);													\
+			if (header[DARRAY_LENGTH] >= header[DARRAY_CAPACITY]) {										\
+				return false;																			\
+			}																							\
+		}																								\
+		vector->spilled[header[DARRAY_LENGTH]++] = value;												\
+		return true;																					\
+	}																									\
+	static inline type small_vector_##name##_pop(small_vector_##name* vector) {						\
+		uint64_t* length = small_vector_##name##_length_ptr(vector);									\
+		return small_vector_##name##_data(vector)[--(*length)];										\
+	}																									\
+	/* Keeps the order of the remaining elements. */													\
+	static inline void small_vector_##name##_remove_at(small_vector_##name* vector, uint64_t index) {	\
+		type* data = small_vector_##name##_data(vector);												\
+		uint64_t* length = small_vector_##name##_length_ptr(vector);									\
+		for (uint64_t i = index + 1; i < *length; ++i) {												\
+			data[i - 1] = data[i];																		\
+		}																								\
+		(*length)--;																					\
+	}																									\
+	static inline void small_vector_##name##_swap_remove(small_vector_##name* vector, uint64_t index) {	\
+		type* data = small_vector_##name##_data(vector);												\
+		uint64_t* length = small_vector_##name##_length_ptr(vector);									\
+		data[index] = data[--(*length)];																\
+	}																									\
+	static inline void small_vector_##name##_clear(small_vector_##name* vector) {						\
+		*small_vector_##name##_length_ptr(vector) = 0;													\
+	}
@@ -0,0 +1,174 @@
+#include "soa_array.h"
+
+#include "../core/gmemory.h"
+#include "../core/logger.h"
+
+#define SOA_ARRAY_STREAM_ALIGNMENT 64
+
+static uint64_t soa_array_round_capacity(uint64_t capacity) {
+	if (capacity < SOA_ARRAY_LANE_PADDING) {
+		capacity = SOA_ARRAY_LANE_PADDING;
+	}
+	return (capacity + SOA_ARRAY_LANE_PADDING - 1) & ~(uint64_t)(SOA_ARRAY_LANE_PADDING - 1);
+}
+
+static uint64_t soa_array_stream_size(uint32_t field_size, uint64_t capacity) {
+	return ((uint64_t)field_size * capacity + SOA_ARRAY_STREAM_ALIGNMENT - 1) & ~(uint64_t)(SOA_ARRAY_STREAM_ALIGNMENT - 1);
+}
+
+// Allocates a block for capacity elements and points fields into it.
+static bool soa_array_allocate(soa_array* array, uint64_t capacity, void** out_fields, void** out_block, uint64_t* out_block_size) {
+	uint64_t block_size = 0;
+	for (uint32_t i = 0; i < array->field_count; ++i) {
+		block_size += soa_array_stream_size(array->field_sizes[i], capacity);
+	}
+
+	uint8_t* block = gallocate_flags(block_size, MEMORY_TAG_ARRAY, MEMORY_FLAG_NO_ZERO | MEMORY_FLAG_ALIGN_64);
+	if (!block) {
+		KERROR("soa_array - failed to allocate %llu elements (%lluB).", capacity, block_size);
+		return false;
+	}
+
+	uint64_t offset = 0;
+	for (uint32_t i = 0; i < array->field_count; ++i) {
+		out_fields[i] = block + offset;
+		offset += soa_array_stream_size(array->field_sizes[i], capacity);
+	}
+	*out_block = block;
+	*out_block_size = block_size;
+	return true;
+}
+
+bool soa_array_create(uint32_t field_count, const uint32_t* field_sizes, uint64_t capacity, soa_array* out_array) {
+	if (!out_array || !field_sizes || field_count == 0 || field_count > SOA_ARRAY_MAX_FIELDS) {
+		KERROR("soa_array_create - requires an array and 1 to %u field sizes.", SOA_ARRAY_MAX_FIELDS);
+		return false;
+	}
+
+	gzero_memory(out_array, sizeof(soa_array));
+	out_array->field_count = field_count;
+	for (uint32_t i = 0; i < field_count; ++i) {
+		if (field_sizes[i] == 0) {
+			KERROR("soa_array_create - field %u has a size of 0.", i);
+			return false;
+		}
+		out_array->field_sizes[i] = field_sizes[i];
+	}
+
+	capacity = soa_array_round_capacity(capacity);
+	if (!soa_array_allocate(out_array, capacity, out_array->fields, &out_array->block, &out_array->block_size)) {
+		return false;
+	}
+	out_array->capacity = capacity;
+	return true;
+}
+
+void soa_array_destroy(soa_array* array) {
+	if (array && array->block) {
+		gfree_flags(array->block, array->block_size, MEMORY_TAG_ARRAY, MEMORY_FLAG_ALIGN_64);
+		gzero_memory(array, sizeof(soa_array));
+	}
+}
+
+bool soa_array_reserve(soa_array* array, uint64_t capacity) {
+	if (capacity <= array->capacity) {
+		return true;
+	}
+
+	capacity = soa_array_round_capacity(capacity);
+	void* fields[SOA_ARRAY_MAX_FIELDS];
+	void* block;
+	uint64_t block_size;
+	if (!soa_array_allocate(array, capacity, fields, &block, &block_size)) {
+		return false;
+	}
+
+	// Stream offsets depend on capacity, so every stream moves separately.
+	for (uint32_t i = 0; i < array->field_count; ++i) {
+		gcopy_memory(fields[i], array->fields[i], array->length * array->field_sizes[i]);
+		array->fields[i] = fields[i];
+	}
+	gfree_flags(array->block, array->block_size, MEMORY_TAG_ARRAY, MEMORY_FLAG_ALIGN_64);
+	array->block = block;
+	array->block_size = block_size;
+	array->capacity = capacity;
+	return true;
+}
+
+static bool soa_array_ensure(soa_array* array, uint64_t count) {
+	if (array->length + count <= array->capacity) {
+		return true;
+	}
+	uint64_t capacity = array->capacity * 2;
+	if (capacity < array->length + count) {
+		capacity = array->length + count;
+	}
+	return soa_array_reserve(array, capacity);
+}
+
+uint64_t soa_array_push(soa_array* array, const void* const* field_values) {
+	if (!soa_array_ensure(array, 1)) {
+		return SOA_ARRAY_INVALID_INDEX;
+	}
+
+	uint64_t index = array->length++;
+	for (uint32_t i = 0; i < array->field_count; ++i) {
+		void* element = soa_array_element(array, i, index);
+		if (field_values && field_values[i]) {
+			gcopy_memory(element, field_values[i], array->field_sizes[i]);
+		} else {
+			gzero_memory(element, array->field_sizes[i]);
+		}
+	}
+	return index;
+}
+
+uint64_t soa_array_push_n(soa_array* array, uint64_t count) {
+	if (!soa_array_ensure(array, count)) {
+		return SOA_ARRAY_INVALID_INDEX;
+	}
+
+	uint64_t first = array->length;
+	for (uint32_t i = 0; i < array->field_count; ++i) {
+		gzero_memory(soa_array_element(array, i, first), count * array->field_sizes[i]);
+	}
+	array->length += count;
+	return first;
+}
+
+uint64_t soa_array_swap_remove(soa_array* array, uint64_t index) {
+	if (index >= array->length) {
+		KERROR("soa_array_swap_remove - index %llu outside length %llu.", index, array->length);
+		return SOA_ARRAY_INVALID_INDEX;
+	}
+
+	uint64_t last = --array->length;
+	if (index != last) {
+		for (uint32_t i = 0; i < array->field_count; ++i) {
+			gcopy_memory(soa_array_element(array, i, index), soa_array_element(array, i, last), array->field_sizes[i]);
+		}
+	}
+	return last;
+}
+
+void soa_array_remove_at(soa_array* array, uint64_t index) {
+	if (index >= array->length) {
+		KERROR("soa_array_remove_at - index %llu outside length %llu.", index, array->length);
+		return;
+	}
+
+	uint64_t tail = array->length - index - 1;
+	if (tail) {
+		for (uint32_t i = 0; i < array->field_count; ++i) {
+			memmove(
+				soa_array_element(array, i, index),
+				soa_array_element(array, i, index + 1),
+				tail * array->field_sizes[i]);
+		}
+	}
+	array->length--;
+}
+
+void soa_array_clear(soa_array* array) {
+	array->length = 0;
+}
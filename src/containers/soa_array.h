@@ -0,0 +1,62 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Struct-of-arrays storage: every field of an element lives in its own
+// stream, so a kernel that only touches positions reads nothing but
+// positions and can fill whole SIMD lanes. All streams share one length and
+// one capacity and always move together.
+//
+// Streams are 64-byte aligned and capacity is a multiple of
+// SOA_ARRAY_LANE_PADDING, so kernels may run to soa_array_padded_length and
+// skip the scalar tail. Values in the padding are unspecified.
+
+#define SOA_ARRAY_MAX_FIELDS 16
+#define SOA_ARRAY_LANE_PADDING 16
+#define SOA_ARRAY_INVALID_INDEX UINT64_MAX
+
+typedef struct soa_array {
+	uint64_t length;
+	uint64_t capacity;
+	uint32_t field_count;
+	uint32_t field_sizes[SOA_ARRAY_MAX_FIELDS];
+	void* fields[SOA_ARRAY_MAX_FIELDS];
+	// Single allocation holding every stream.
+	void* block;
+	uint64_t block_size;
+} soa_array;
+
+bool soa_array_create(uint32_t field_count, const uint32_t* field_sizes, uint64_t capacity, soa_array* out_array);
+void soa_array_destroy(soa_array* array);
+
+bool soa_array_reserve(soa_array* array, uint64_t capacity);
+
+// field_values holds one pointer per field; a 0 array or a 0 entry zeroes
+// that field. Returns the new index, or SOA_ARRAY_INVALID_INDEX.
+uint64_t soa_array_push(soa_array* array, const void* const* field_values);
+// Appends count zeroed elements for a kernel to fill. Returns the first new
+// index, or SOA_ARRAY_INVALID_INDEX.
+uint64_t soa_array_push_n(soa_array* array, uint64_t count);
+
+// Moves the last element into index. Returns the index the moved element
+// came from so callers can fix up references, or index when it was last.
+uint64_t soa_array_swap_remove(soa_array* array, uint64_t index);
+// Keeps the order of the remaining elements.
+void soa_array_remove_at(soa_array* array, uint64_t index);
+void soa_array_clear(soa_array* array);
+
+static inline void* soa_array_field(const soa_array* array, uint32_t field) {
+	return array->fields[field];
+}
+
+static inline void* soa_array_element(const soa_array* array, uint32_t field, uint64_t index) {
+	return (uint8_t*)array->fields[field] + index * array->field_sizes[field];
+}
+
+static inline uint64_t soa_array_padded_length(const soa_array* array) {
+	return (array->length + SOA_ARRAY_LANE_PADDING - 1) & ~(uint64_t)(SOA_ARRAY_LANE_PADDING - 1);
+}
+
+// Typed stream access, e.g. float* x = soa_array_stream(&particles, float, PARTICLE_X);
+#define soa_array_stream(array, type, field) \
+		((type*)soa_array_field(array, field))
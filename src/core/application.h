@@ -1,19 +1,23 @@
-#pragma once
-#include <stdint.h>
-
-struct game;
-
-typedef struct application_config {
-	int16_t start_pos_x;
-	int16_t start_pos_y;
-
-	int16_t start_width;
-	int16_t start_height;
-	char* name;
-} application_config;
-
-uint8_t application_create(struct game* game_inst);
-
-uint8_t application_run();
-
-void application_get_framebuffer_size(uint32_t* width, uint32_t* height);
\ No newline at end of file
+#pragma once
+#include <stdint.h>
+
+struct game;
+struct frame_allocator;
+
+typedef struct application_config {
+	int16_t start_pos_x;
+	int16_t start_pos_y;
+
+	int16_t start_width;
+	int16_t start_height;
+	char* name;
+} application_config;
+
+uint8_t application_create(struct game* game_inst);
+
+uint8_t application_run();
+
+void application_get_framebuffer_size(uint32_t* width, uint32_t* height);
+
+// Transient memory that lives until the same frame slot comes around again.
+struct frame_allocator* application_get_frame_allocator();
\ No newline at end of file
@@ -1,134 +1,621 @@
-#include "gmemory.h"
-#include "logger.h"
-#include "../platform/platform.h"
-
-#include "gstring.h"
-#include<string.h>
-#include <stdio.h>
-
-#include <stdlib.h>
-
-struct memory_stats {
-	uint64_t total_allocated;
-	uint64_t tagged_allocations[MEMORY_TAG_MAX_TAGS];
-};
-
-static const char* memory_tag_strings[MEMORY_TAG_MAX_TAGS] = {
-	"UNKNOWN    ",
-	"ARRAY      ",
-	"DARRAY     ",
-	"DICT       ",
-	"RING_QUEUE ",
-	"BST        ",
-	"STRING     ",
-	"APPLICATION",
-	"JOB        ",
-	"TEXTURE    ",
-	"MAT_INST   ",
-	"RENDERER   ",
-	"GAME       ",
-	"TRANSFORM  ",
-	"ENTITY     ",
-	"ENTITY_NODE",
-	"SCENE      ",
-	"LINEAR_ALLOCATOR"};
-
-typedef struct memory_system_state {
-	struct memory_stats stats;
-	uint64_t alloc_count;
-}  memory_system_state;
-
-static memory_system_state* state_ptr;
-
-void memory_system_initialize(uint64_t* memory_requirement, void* state) {
-	*memory_requirement = sizeof(memory_system_state);
-	if (state == 0) {
-		return;
-	}
-
-	state_ptr = state;
-	state_ptr->alloc_count = 0;
-	platform_zero_memory(&state_ptr->stats, sizeof(state_ptr->stats));
-}
-
-void memory_system_shutdown() {
-	state_ptr = 0;
-
-}
-
-void* gallocate(uint64_t size, memory_tag tag) {
-	if (tag == MEMORY_TAG_UNKNOWN) {
-		KWARN("gallocate called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
-	}
-
-	if (state_ptr) {
-		state_ptr->stats.total_allocated += size;
-		state_ptr->stats.tagged_allocations[tag] += size;
-	}
-
-	void* block = platform_allocate(size, 0);
-	if (block == NULL) {
-		KWARN("aaaaaaaaaa %d", size);
-	}
-	platform_zero_memory(block, size);
-	return block;
-}
-
-void gfree(void* block, uint64_t size, memory_tag tag) {
-	if (tag == MEMORY_TAG_UNKNOWN) {
-		KWARN("gfree called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
-	}
-
-	state_ptr->stats.total_allocated -= size;
-	state_ptr->stats.tagged_allocations[tag] -= size;
-
-	platform_free(block, 0);
-}
-
-void* gzero_memory(void* block, uint64_t size) {
-	return platform_zero_memory(block, size);
-}
-
-void* gcopy_memory(void* dest, const void* source, uint64_t size) {
-	return platform_copy_memory(dest, source, size);
-}
-
-void* gset_memory(void* dest, int32_t value, uint64_t size) {
-	return platform_set_memory(dest, value, size);
-}
-
-char* get_memory_usage_str() {
-	const uint64_t gib = 1024 * 1024 * 1024;
-	const uint64_t mib = 1024 * 1024;
-	const uint64_t kib = 1024;
-	
-	char buffer[8000] = "System memory use(tagged):\n";
-	uint64_t offset = strlen(buffer);
-
-	for (uint32_t i = 0; i < MEMORY_TAG_MAX_TAGS; ++i) {
-		char unit[4] = "XiB";
-		float amount = 1.0f;
-
-		if (state_ptr->stats.tagged_allocations[i] >= gib) {
-			unit[0] = 'G';
-			amount = state_ptr->stats.tagged_allocations[i] / (float)gib;
-		} else if (state_ptr->stats.tagged_allocations[i] >= mib) {
-			unit[0] = 'M';
-			amount = state_ptr->stats.tagged_allocations[i] / (float)mib;
-		}
-		else if (state_ptr->stats.tagged_allocations[i] >= kib) {
-			unit[0] = 'K';
-			amount = state_ptr->stats.tagged_allocations[i] / (float)kib;
-		}
-		else {
-			unit[0] = 'B';
-			unit[1] = 0;
-			amount = (float)state_ptr->stats.tagged_allocations[i];
-		}
-
-		int32_t length = snprintf(buffer + offset, 8000, "  %s: %.2f%s\n", memory_tag_strings[i], amount, unit);
-		offset += length;
-	}
-	char* out_string = string_duplicate(buffer);
-	return out_string;
+#include "gmemory.h"
+#include "logger.h"
+#include "asserts.h"
+#include "event.h"
+#include "../platform/platform.h"
+#include "../memory/dynamic_allocator.h"
+#include "../memory/pool_allocator.h"
+#include "../memory/allocation_profiler.h"
+
+#include "gstring.h"
+#include<string.h>
+#include <stdio.h>
+
+#include <stdlib.h>
+
+// Written only by the owning thread, except for the shared overflow slot.
+// Each set starts on its own cache line so threads never contend.
+typedef struct memory_thread_stats {
+	volatile int64_t allocated[MEMORY_TAG_MAX_TAGS];
+	volatile int64_t aligned[MEMORY_TAG_MAX_TAGS];
+	volatile int64_t huge_pages[MEMORY_TAG_MAX_TAGS];
+	volatile int64_t no_zero[MEMORY_TAG_MAX_TAGS];
+	volatile int64_t allocation_count[MEMORY_TAG_MAX_TAGS];
+	volatile int64_t free_count[MEMORY_TAG_MAX_TAGS];
+} memory_thread_stats;
+
+#define MEMORY_THREAD_STATS_STRIDE ((sizeof(memory_thread_stats) + 63) & ~(uint64_t)63)
+
+static const char* memory_tag_strings[MEMORY_TAG_MAX_TAGS] = {
+	"UNKNOWN    ",
+	"ARRAY      ",
+	"DARRAY     ",
+	"DICT       ",
+	"RING_QUEUE ",
+	"BST        ",
+	"STRING     ",
+	"APPLICATION",
+	"JOB        ",
+	"TEXTURE    ",
+	"MAT_INST   ",
+	"RENDERER   ",
+	"GAME       ",
+	"TRANSFORM  ",
+	"ENTITY     ",
+	"ENTITY_NODE",
+	"SCENE      ",
+	"LINEAR_ALLOCATOR",
+	"DYNAMIC_ALLOCATOR",
+	"VIRTUAL_ARENA"};
+
+typedef struct memory_system_state {
+	// MEMORY_MAX_TRACKED_THREADS private sets plus the shared overflow set.
+	uint8_t* thread_stats;
+	volatile int32_t thread_count;
+
+	platform_mutex stats_lock;
+	uint64_t peak_total_allocated;
+	uint64_t tag_peaks[MEMORY_TAG_MAX_TAGS];
+	uint64_t frame_start_allocation_count;
+	uint64_t frame_allocation_count;
+
+	// Engine heap for MEMORY_FLAG_LONG_LIVED allocations.
+	uint64_t heap_size;
+	void* heap_memory;
+	dynamic_allocator heap;
+	platform_mutex heap_lock;
+
+	memory_budget budgets[MEMORY_TAG_MAX_TAGS];
+	volatile int64_t budget_allocated[MEMORY_TAG_MAX_TAGS];
+	// Set when a tag crosses its soft limit, cleared once the event is fired.
+	volatile int32_t budget_low_pending[MEMORY_TAG_MAX_TAGS];
+
+	// Only created with track_allocations.
+	allocation_profiler* profiler;
+	allocation_profiler profiler_storage;
+	const char* allocation_stacks_path;
+
+	platform_mutex pool_lock;
+	uint32_t pool_count;
+	struct pool_allocator* pools[MEMORY_MAX_REGISTERED_POOLS];
+}  memory_system_state;
+
+static memory_system_state* state_ptr;
+
+static _Thread_local memory_thread_stats* thread_stats;
+// System instance thread_stats was claimed from, in case it is restarted.
+static _Thread_local memory_system_state* thread_stats_owner;
+
+void memory_system_initialize(uint64_t* memory_requirement, void* state, memory_system_config* config) {
+	*memory_requirement = sizeof(memory_system_state);
+	if (state == 0) {
+		return;
+	}
+
+	state_ptr = state;
+	platform_zero_memory(state_ptr, sizeof(memory_system_state));
+	platform_mutex_create(&state_ptr->pool_lock);
+	platform_mutex_create(&state_ptr->stats_lock);
+
+	// Page aligned, which also puts every set on its own cache line.
+	state_ptr->thread_stats = platform_allocate_pages(MEMORY_THREAD_STATS_STRIDE * (MEMORY_MAX_TRACKED_THREADS + 1), false);
+
+	if (config && config->heap_size) {
+		// Mapped directly so the arena itself is not counted against any tag.
+		state_ptr->heap_size = config->heap_size;
+		state_ptr->heap_memory = platform_allocate_pages(state_ptr->heap_size, true);
+		if (!state_ptr->heap_memory || !dynamic_allocator_create(state_ptr->heap_size, state_ptr->heap_memory, &state_ptr->heap)) {
+			KERROR("memory_system_initialize - failed to create the %lluB engine heap, using the platform heap instead.", state_ptr->heap_size);
+			platform_free_pages(state_ptr->heap_memory, state_ptr->heap_size, true);
+			state_ptr->heap_memory = 0;
+		} else {
+			platform_mutex_create(&state_ptr->heap_lock);
+		}
+	}
+
+	if (config && config->track_allocations) {
+		uint32_t max_tracked = config->max_tracked_allocations ? config->max_tracked_allocations : 1024 * 1024;
+		if (allocation_profiler_create(max_tracked, &state_ptr->profiler_storage)) {
+			state_ptr->profiler = &state_ptr->profiler_storage;
+			state_ptr->allocation_stacks_path = config->allocation_stacks_path;
+			KINFO("Allocation tracking enabled for up to %u live allocations.", max_tracked);
+		}
+	}
+}
+
+void memory_system_shutdown() {
+	if (state_ptr && state_ptr->profiler) {
+		if (state_ptr->allocation_stacks_path) {
+			allocation_profiler_write_collapsed_stacks(state_ptr->profiler, state_ptr->allocation_stacks_path);
+		}
+		allocation_profiler_report_leaks(state_ptr->profiler);
+		allocation_profiler_destroy(state_ptr->profiler);
+		state_ptr->profiler = 0;
+	}
+	if (state_ptr && state_ptr->heap_memory) {
+		dynamic_allocator_destroy(&state_ptr->heap);
+		platform_mutex_destroy(&state_ptr->heap_lock);
+		platform_free_pages(state_ptr->heap_memory, state_ptr->heap_size, true);
+		state_ptr->heap_memory = 0;
+	}
+	if (state_ptr) {
+		platform_mutex_destroy(&state_ptr->pool_lock);
+		platform_mutex_destroy(&state_ptr->stats_lock);
+		platform_free_pages(state_ptr->thread_stats, MEMORY_THREAD_STATS_STRIDE * (MEMORY_MAX_TRACKED_THREADS + 1), false);
+	}
+	state_ptr = 0;
+}
+
+void memory_system_register_pool(struct pool_allocator* pool) {
+	if (!state_ptr) {
+		return;
+	}
+
+	platform_mutex_lock(&state_ptr->pool_lock);
+	if (state_ptr->pool_count < MEMORY_MAX_REGISTERED_POOLS) {
+		state_ptr->pools[state_ptr->pool_count++] = pool;
+	} else {
+		KWARN("memory_system_register_pool - too many pools, '%s' will not be reported.", pool->name);
+	}
+	platform_mutex_unlock(&state_ptr->pool_lock);
+}
+
+void memory_system_unregister_pool(struct pool_allocator* pool) {
+	if (!state_ptr) {
+		return;
+	}
+
+	platform_mutex_lock(&state_ptr->pool_lock);
+	for (uint32_t i = 0; i < state_ptr->pool_count; ++i) {
+		if (state_ptr->pools[i] == pool) {
+			state_ptr->pools[i] = state_ptr->pools[--state_ptr->pool_count];
+			break;
+		}
+	}
+	platform_mutex_unlock(&state_ptr->pool_lock);
+}
+
+static uint8_t memory_flags_alignment(memory_flags flags) {
+	if (flags & MEMORY_FLAG_ALIGN_64) {
+		return 64;
+	} else if (flags & MEMORY_FLAG_ALIGN_32) {
+		return 32;
+	} else if (flags & MEMORY_FLAG_ALIGN_16) {
+		return 16;
+	}
+	return 0;
+}
+
+static memory_thread_stats* memory_thread_stats_get(bool* out_shared) {
+	if (thread_stats_owner != state_ptr) {
+		int32_t slot = platform_atomic_add_i32(&state_ptr->thread_count, 1) - 1;
+		if (slot >= MEMORY_MAX_TRACKED_THREADS) {
+			slot = MEMORY_MAX_TRACKED_THREADS;
+		}
+		thread_stats = (memory_thread_stats*)(state_ptr->thread_stats + MEMORY_THREAD_STATS_STRIDE * slot);
+		thread_stats_owner = state_ptr;
+	}
+	*out_shared = thread_stats == (memory_thread_stats*)(state_ptr->thread_stats + MEMORY_THREAD_STATS_STRIDE * MEMORY_MAX_TRACKED_THREADS);
+	return thread_stats;
+}
+
+static void memory_counter_add(volatile int64_t* counter, int64_t amount, bool shared) {
+	if (shared) {
+		platform_atomic_add_i64(counter, amount);
+	} else {
+		platform_atomic_store_relaxed_i64(counter, platform_atomic_load_relaxed_i64(counter) + amount);
+	}
+}
+
+static void memory_stats_track(uint64_t size, memory_tag tag, memory_flags flags, bool add) {
+	if (!state_ptr || !state_ptr->thread_stats) {
+		return;
+	}
+
+	bool shared;
+	memory_thread_stats* stats = memory_thread_stats_get(&shared);
+	int64_t amount = add ? (int64_t)size : -(int64_t)size;
+	memory_counter_add(&stats->allocated[tag], amount, shared);
+	memory_counter_add(add ? &stats->allocation_count[tag] : &stats->free_count[tag], 1, shared);
+
+	if (memory_flags_alignment(flags)) {
+		memory_counter_add(&stats->aligned[tag], amount, shared);
+	}
+	if ((flags & MEMORY_FLAG_NO_ZERO) && add) {
+		memory_counter_add(&stats->no_zero[tag], amount, shared);
+	}
+	if (flags & MEMORY_FLAG_HUGE_PAGES) {
+		memory_counter_add(&stats->huge_pages[tag], amount, shared);
+	}
+}
+
+void memory_system_set_budget(memory_tag tag, memory_budget budget) {
+	if (!state_ptr) {
+		return;
+	}
+
+	// Start from what the tag already holds.
+	memory_stats_snapshot snapshot;
+	memory_system_get_stats(&snapshot);
+	platform_atomic_store_i64(&state_ptr->budget_allocated[tag], (int64_t)snapshot.tags[tag].allocated);
+	state_ptr->budgets[tag] = budget;
+}
+
+static bool memory_budget_has_limit(memory_tag tag) {
+	return state_ptr && (state_ptr->budgets[tag].soft_limit || state_ptr->budgets[tag].hard_limit);
+}
+
+// Charges size against the tag's budget. Returns false when the hard limit
+// policy refuses the allocation.
+static bool memory_budget_charge(uint64_t size, memory_tag tag) {
+	memory_budget* budget = &state_ptr->budgets[tag];
+	uint64_t allocated = (uint64_t)platform_atomic_add_i64(&state_ptr->budget_allocated[tag], (int64_t)size);
+
+	if (budget->hard_limit && allocated > budget->hard_limit) {
+		switch (budget->policy) {
+			case MEMORY_BUDGET_POLICY_WARN:
+				KWARN("gallocate - %lluB takes tag %s to %lluB, past its %lluB hard limit.", size, memory_tag_strings[tag], allocated, budget->hard_limit);
+				break;
+			case MEMORY_BUDGET_POLICY_FATAL:
+				KFATAL("gallocate - %lluB takes tag %s to %lluB, past its %lluB hard limit.", size, memory_tag_strings[tag], allocated, budget->hard_limit);
+				kdebug_break();
+				break;
+			case MEMORY_BUDGET_POLICY_FAIL:
+			default:
+				platform_atomic_add_i64(&state_ptr->budget_allocated[tag], -(int64_t)size);
+				KERROR("gallocate - refused %lluB for tag %s, it would pass its %lluB hard limit.", size, memory_tag_strings[tag], budget->hard_limit);
+				return false;
+		}
+	}
+
+	if (budget->soft_limit && allocated > budget->soft_limit && allocated - size <= budget->soft_limit) {
+		platform_atomic_store_i32(&state_ptr->budget_low_pending[tag], 1);
+	}
+	return true;
+}
+
+static void memory_budget_fire_events() {
+	for (uint32_t tag = 0; tag < MEMORY_TAG_MAX_TAGS; ++tag) {
+		if (platform_atomic_exchange_i32(&state_ptr->budget_low_pending[tag], 0)) {
+			event_context context = {0};
+			context.data.u32[0] = tag;
+			context.data.u64[1] = (uint64_t)platform_atomic_load_i64(&state_ptr->budget_allocated[tag]);
+			KWARN("Memory tag %s is over its %lluB soft limit.", memory_tag_strings[tag], state_ptr->budgets[tag].soft_limit);
+			event_fire(EVENT_CODE_MEMORY_LOW, 0, context);
+		}
+	}
+}
+
+// Expects stats_lock to be held. Folds the current totals into the peaks.
+static void memory_stats_merge(memory_stats_snapshot* out_snapshot) {
+	platform_zero_memory(out_snapshot, sizeof(memory_stats_snapshot));
+	int32_t thread_count = platform_atomic_load_i32(&state_ptr->thread_count);
+	out_snapshot->thread_count = (uint32_t)thread_count;
+	uint32_t slot_count = thread_count < MEMORY_MAX_TRACKED_THREADS ? (uint32_t)thread_count : MEMORY_MAX_TRACKED_THREADS + 1;
+
+	// Blocks freed on another thread than they were allocated on leave one
+	// set negative and another positive, so sum signed and clamp at the end.
+	int64_t allocated[MEMORY_TAG_MAX_TAGS] = {0};
+	int64_t aligned[MEMORY_TAG_MAX_TAGS] = {0};
+	int64_t huge_pages[MEMORY_TAG_MAX_TAGS] = {0};
+	for (uint32_t i = 0; i < slot_count; ++i) {
+		memory_thread_stats* stats = (memory_thread_stats*)(state_ptr->thread_stats + MEMORY_THREAD_STATS_STRIDE * i);
+		for (uint32_t tag = 0; tag < MEMORY_TAG_MAX_TAGS; ++tag) {
+			allocated[tag] += platform_atomic_load_relaxed_i64(&stats->allocated[tag]);
+			aligned[tag] += platform_atomic_load_relaxed_i64(&stats->aligned[tag]);
+			huge_pages[tag] += platform_atomic_load_relaxed_i64(&stats->huge_pages[tag]);
+			out_snapshot->tags[tag].no_zero += platform_atomic_load_relaxed_i64(&stats->no_zero[tag]);
+			out_snapshot->tags[tag].allocation_count += platform_atomic_load_relaxed_i64(&stats->allocation_count[tag]);
+			out_snapshot->tags[tag].free_count += platform_atomic_load_relaxed_i64(&stats->free_count[tag]);
+		}
+	}
+
+	for (uint32_t tag = 0; tag < MEMORY_TAG_MAX_TAGS; ++tag) {
+		memory_tag_stats* tag_stats = &out_snapshot->tags[tag];
+		tag_stats->allocated = allocated[tag] > 0 ? (uint64_t)allocated[tag] : 0;
+		tag_stats->aligned = aligned[tag] > 0 ? (uint64_t)aligned[tag] : 0;
+		tag_stats->huge_pages = huge_pages[tag] > 0 ? (uint64_t)huge_pages[tag] : 0;
+		if (tag_stats->allocated > state_ptr->tag_peaks[tag]) {
+			state_ptr->tag_peaks[tag] = tag_stats->allocated;
+		}
+		tag_stats->peak = state_ptr->tag_peaks[tag];
+
+		out_snapshot->total_allocated += tag_stats->allocated;
+		out_snapshot->allocation_count += tag_stats->allocation_count;
+		out_snapshot->free_count += tag_stats->free_count;
+	}
+
+	if (out_snapshot->total_allocated > state_ptr->peak_total_allocated) {
+		state_ptr->peak_total_allocated = out_snapshot->total_allocated;
+	}
+	out_snapshot->peak_total_allocated = state_ptr->peak_total_allocated;
+	out_snapshot->frame_allocation_count = state_ptr->frame_allocation_count;
+}
+
+void memory_system_get_stats(memory_stats_snapshot* out_snapshot) {
+	if (!state_ptr || !state_ptr->thread_stats) {
+		platform_zero_memory(out_snapshot, sizeof(memory_stats_snapshot));
+		return;
+	}
+
+	platform_mutex_lock(&state_ptr->stats_lock);
+	memory_stats_merge(out_snapshot);
+	platform_mutex_unlock(&state_ptr->stats_lock);
+}
+
+void memory_system_begin_frame() {
+	if (!state_ptr || !state_ptr->thread_stats) {
+		return;
+	}
+
+	memory_stats_snapshot snapshot;
+	platform_mutex_lock(&state_ptr->stats_lock);
+	memory_stats_merge(&snapshot);
+	state_ptr->frame_allocation_count = snapshot.allocation_count - state_ptr->frame_start_allocation_count;
+	state_ptr->frame_start_allocation_count = snapshot.allocation_count;
+	platform_mutex_unlock(&state_ptr->stats_lock);
+
+	if (state_ptr->profiler) {
+		allocation_profiler_on_frame(state_ptr->profiler);
+	}
+
+	memory_budget_fire_events();
+}
+
+bool memory_system_write_allocation_stacks(const char* path) {
+	if (!state_ptr || !state_ptr->profiler) {
+		KWARN("memory_system_write_allocation_stacks - allocation tracking is not enabled.");
+		return false;
+	}
+	return allocation_profiler_write_collapsed_stacks(state_ptr->profiler, path);
+}
+
+void memory_system_track_external(uint64_t size, memory_tag tag, bool allocated) {
+	memory_stats_track(size, tag, MEMORY_FLAG_NONE, allocated);
+	// The memory is already mapped, so it can only be counted, not refused.
+	if (memory_budget_has_limit(tag)) {
+		platform_atomic_add_i64(&state_ptr->budget_allocated[tag], allocated ? (int64_t)size : -(int64_t)size);
+	}
+}
+
+void gfree(void* block, uint64_t size, memory_tag tag) {
+	gfree_flags(block, size, tag, MEMORY_FLAG_NONE);
+}
+
+void* _gallocate_flags(uint64_t size, memory_tag tag, memory_flags flags, const char* file, uint32_t line) {
+	if (tag == MEMORY_TAG_UNKNOWN) {
+		KWARN("gallocate called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
+	}
+
+	if (memory_budget_has_limit(tag) && !memory_budget_charge(size, tag)) {
+		return 0;
+	}
+
+	void* block = 0;
+	uint8_t alignment = memory_flags_alignment(flags);
+	if ((flags & MEMORY_FLAG_LONG_LIVED) && !(flags & MEMORY_FLAG_HUGE_PAGES) && state_ptr && state_ptr->heap_memory) {
+		platform_mutex_lock(&state_ptr->heap_lock);
+		block = dynamic_allocator_allocate_aligned(&state_ptr->heap, size, alignment);
+		platform_mutex_unlock(&state_ptr->heap_lock);
+		if (block && !(flags & MEMORY_FLAG_NO_ZERO)) {
+			platform_zero_memory(block, size);
+		}
+	}
+
+	if (!block) {
+		if (flags & MEMORY_FLAG_HUGE_PAGES) {
+			// Fresh pages are already zeroed and huge page aligned.
+			block = platform_allocate_pages(size, true);
+		} else {
+			block = platform_allocate(size, alignment);
+			if (block && !(flags & MEMORY_FLAG_NO_ZERO)) {
+				platform_zero_memory(block, size);
+			}
+		}
+	}
+
+	if (block == NULL) {
+		KERROR("gallocate - failed to allocate %llu bytes.", size);
+		if (memory_budget_has_limit(tag)) {
+			platform_atomic_add_i64(&state_ptr->budget_allocated[tag], -(int64_t)size);
+		}
+		return 0;
+	}
+
+	memory_stats_track(size, tag, flags, true);
+	if (state_ptr && state_ptr->profiler) {
+		allocation_profiler_on_allocate(state_ptr->profiler, block, size, tag, file, line);
+	}
+	return block;
+}
+
+void gfree_flags(void* block, uint64_t size, memory_tag tag, memory_flags flags) {
+	if (tag == MEMORY_TAG_UNKNOWN) {
+		KWARN("gfree called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
+	}
+
+	memory_stats_track(size, tag, flags, false);
+	if (memory_budget_has_limit(tag)) {
+		platform_atomic_add_i64(&state_ptr->budget_allocated[tag], -(int64_t)size);
+	}
+	if (state_ptr && state_ptr->profiler) {
+		allocation_profiler_on_free(state_ptr->profiler, block);
+	}
+
+	if (state_ptr && state_ptr->heap_memory && dynamic_allocator_owns(&state_ptr->heap, block)) {
+		platform_mutex_lock(&state_ptr->heap_lock);
+		dynamic_allocator_free(&state_ptr->heap, block);
+		platform_mutex_unlock(&state_ptr->heap_lock);
+	} else if (flags & MEMORY_FLAG_HUGE_PAGES) {
+		platform_free_pages(block, size, true);
+	} else {
+		platform_free(block, memory_flags_alignment(flags));
+	}
+}
+
+void* _greallocate_flags(void* block, uint64_t old_size, uint64_t new_size, memory_tag tag, memory_flags flags, const char* file, uint32_t line) {
+	if (!block) {
+		return _gallocate_flags(new_size, tag, flags, file, line);
+	}
+
+	// Engine heap and page mapped blocks have no in-place path, so move them.
+	bool in_heap = state_ptr && state_ptr->heap_memory && dynamic_allocator_owns(&state_ptr->heap, block);
+	if (in_heap || (flags & MEMORY_FLAG_HUGE_PAGES)) {
+		void* new_block = _gallocate_flags(new_size, tag, flags | MEMORY_FLAG_NO_ZERO, file, line);
+		if (!new_block) {
+			return 0;
+		}
+		uint64_t kept = old_size < new_size ? old_size : new_size;
+		gcopy_memory(new_block, block, kept);
+		if (!(flags & MEMORY_FLAG_NO_ZERO)) {
+			gzero_memory((uint8_t*)new_block + kept, new_size - kept);
+		}
+		gfree_flags(block, old_size, tag, flags);
+		return new_block;
+	}
+
+	if (new_size > old_size && memory_budget_has_limit(tag) && !memory_budget_charge(new_size - old_size, tag)) {
+		return 0;
+	}
+
+	void* new_block = platform_reallocate(block, old_size, new_size, memory_flags_alignment(flags));
+	if (!new_block) {
+		KERROR("greallocate - failed to resize %llu bytes to %llu.", old_size, new_size);
+		if (new_size > old_size && memory_budget_has_limit(tag)) {
+			platform_atomic_add_i64(&state_ptr->budget_allocated[tag], -(int64_t)(new_size - old_size));
+		}
+		return 0;
+	}
+
+	if (new_size < old_size && memory_budget_has_limit(tag)) {
+		platform_atomic_add_i64(&state_ptr->budget_allocated[tag], -(int64_t)(old_size - new_size));
+	}
+	if (new_size > old_size && !(flags & MEMORY_FLAG_NO_ZERO)) {
+		gzero_memory((uint8_t*)new_block + old_size, new_size - old_size);
+	}
+
+	// Counted as a free of the old block and an allocation of the new one.
+	memory_stats_track(old_size, tag, flags, false);
+	memory_stats_track(new_size, tag, flags, true);
+	if (state_ptr && state_ptr->profiler) {
+		allocation_profiler_on_free(state_ptr->profiler, block);
+		allocation_profiler_on_allocate(state_ptr->profiler, new_block, new_size, tag, file, line);
+	}
+	return new_block;
+}
+
+static float memory_size_unit(uint64_t size, char* out_unit) {
+	const uint64_t gib = 1024 * 1024 * 1024;
+	const uint64_t mib = 1024 * 1024;
+	const uint64_t kib = 1024;
+
+	if (size >= gib) {
+		out_unit[0] = 'G';
+		return size / (float)gib;
+	} else if (size >= mib) {
+		out_unit[0] = 'M';
+		return size / (float)mib;
+	} else if (size >= kib) {
+		out_unit[0] = 'K';
+		return size / (float)kib;
+	}
+
+	out_unit[0] = 'B';
+	out_unit[1] = 0;
+	return (float)size;
+}
+
+void memory_system_format_usage(string_builder* builder) {
+	memory_stats_snapshot snapshot;
+	memory_system_get_stats(&snapshot);
+
+	string_builder_append(builder, STRING_VIEW_LITERAL("System memory use(tagged):\n"));
+
+	for (uint32_t i = 0; i < MEMORY_TAG_MAX_TAGS; ++i) {
+		memory_tag_stats* tag_stats = &snapshot.tags[i];
+		char unit[4] = "XiB";
+		char peak_unit[4] = "XiB";
+		float amount = memory_size_unit(tag_stats->allocated, unit);
+		float peak_amount = memory_size_unit(tag_stats->peak, peak_unit);
+
+		string_builder_appendf(builder, "  %s: %.2f%s", memory_tag_strings[i], amount, unit);
+
+		if (tag_stats->allocation_count) {
+			string_builder_appendf(builder, " (peak %.2f%s, %llu allocs, %llu frees)",
+				peak_amount, peak_unit, tag_stats->allocation_count, tag_stats->free_count);
+		}
+
+		uint64_t aligned = tag_stats->aligned;
+		uint64_t no_zero = tag_stats->no_zero;
+		uint64_t huge_pages = tag_stats->huge_pages;
+		if (aligned || no_zero || huge_pages) {
+			char aligned_unit[4] = "XiB";
+			char no_zero_unit[4] = "XiB";
+			char huge_pages_unit[4] = "XiB";
+			float aligned_amount = memory_size_unit(aligned, aligned_unit);
+			float no_zero_amount = memory_size_unit(no_zero, no_zero_unit);
+			float huge_pages_amount = memory_size_unit(huge_pages, huge_pages_unit);
+			string_builder_appendf(builder, " (aligned %.2f%s, huge pages %.2f%s, unzeroed total %.2f%s)",
+				aligned_amount, aligned_unit, huge_pages_amount, huge_pages_unit, no_zero_amount, no_zero_unit);
+		}
+
+		memory_budget* budget = &state_ptr->budgets[i];
+		if (budget->soft_limit || budget->hard_limit) {
+			char soft_unit[4] = "XiB";
+			char hard_unit[4] = "XiB";
+			float soft_amount = memory_size_unit(budget->soft_limit, soft_unit);
+			float hard_amount = memory_size_unit(budget->hard_limit, hard_unit);
+			string_builder_appendf(builder, " [budget soft %.2f%s, hard %.2f%s]", soft_amount, soft_unit, hard_amount, hard_unit);
+		}
+
+		string_builder_append_char(builder, '\n');
+	}
+
+	char total_unit[4] = "XiB";
+	char peak_total_unit[4] = "XiB";
+	float total_amount = memory_size_unit(snapshot.total_allocated, total_unit);
+	float peak_total_amount = memory_size_unit(snapshot.peak_total_allocated, peak_total_unit);
+	string_builder_appendf(builder, "Total: %.2f%s (peak %.2f%s), %llu allocations last frame, %u threads\n",
+		total_amount, total_unit, peak_total_amount, peak_total_unit, snapshot.frame_allocation_count, snapshot.thread_count);
+
+	if (state_ptr->heap_memory) {
+		dynamic_allocator_stats heap_stats;
+		platform_mutex_lock(&state_ptr->heap_lock);
+		dynamic_allocator_get_stats(&state_ptr->heap, &heap_stats);
+		platform_mutex_unlock(&state_ptr->heap_lock);
+
+		char used_unit[4] = "XiB";
+		char usable_unit[4] = "XiB";
+		char largest_unit[4] = "XiB";
+		float used_amount = memory_size_unit(heap_stats.allocated, used_unit);
+		float usable_amount = memory_size_unit(heap_stats.usable_size, usable_unit);
+		float largest_amount = memory_size_unit(heap_stats.largest_free_block, largest_unit);
+		string_builder_appendf(builder, "Engine heap: %.2f%s / %.2f%s in %llu blocks, %llu free blocks, largest free %.2f%s, fragmentation %.1f%%\n",
+			used_amount, used_unit, usable_amount, usable_unit, heap_stats.allocation_count,
+			heap_stats.free_block_count, largest_amount, largest_unit, heap_stats.fragmentation * 100.0f);
+	}
+
+	platform_mutex_lock(&state_ptr->pool_lock);
+	for (uint32_t i = 0; i < state_ptr->pool_count; ++i) {
+		struct pool_allocator* pool = state_ptr->pools[i];
+		pool_allocator_stats pool_stats;
+		pool_allocator_get_stats(pool, &pool_stats);
+
+		string_builder_appendf(builder, "Pool '%s':\n", pool->name);
+		for (uint32_t c = 0; c < pool_stats.class_count; ++c) {
+			pool_class_stats* class_stats = &pool_stats.classes[c];
+			float occupancy = class_stats->capacity ? class_stats->in_use * 100.0f / class_stats->capacity : 0.0f;
+			string_builder_appendf(builder, "  %5uB: %llu / %llu blocks (%.1f%%), peak %llu, %llu slabs\n",
+				class_stats->block_size, class_stats->in_use, class_stats->capacity, occupancy, class_stats->peak_in_use, class_stats->slab_count);
+		}
+	}
+	platform_mutex_unlock(&state_ptr->pool_lock);
+}
+
+const char* get_memory_usage_str() {
+	static _Thread_local char buffer[16000];
+	string_builder builder;
+	string_builder_init_buffer(&builder, buffer, sizeof(buffer));
+	memory_system_format_usage(&builder);
+	return buffer;
 }
\ No newline at end of file
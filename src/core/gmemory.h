@@ -1,37 +1,221 @@
-#pragma once
-
-#include <stdint.h>
-
-typedef enum memory_tag {
-	MEMORY_TAG_UNKNOWN,
-	MEMORY_TAG_ARRAY,
-	MEMORY_TAG_DARRAY,
-	MEMORY_TAG_DICT,
-	MEMORY_TAG_RING_QUEUE,
-	MEMORY_TAG_BST,
-	MEMORY_TAG_STRING,
-	MEMORY_TAG_APPLICATION,
-	MEMORY_TAG_JOB,
-	MEMORY_TAG_TEXTURE,
-	MEMORY_TAG_MATERIAL_INSTANCE,
-	MEMORY_TAG_RENDERER,
-	MEMORY_TAG_GAME,
-	MEMORY_TAG_TRANSFORM,
-	MEMORY_TAG_ENTITY,
-	MEMORY_TAG_ENTITY_NODE,
-	MEMORY_TAG_SCENE,
-	MEMORY_TAG_LINEAR_ALLOCATOR,
-
-	MEMORY_TAG_MAX_TAGS
-} memory_tag;
-
-void memory_system_initialize(uint64_t* memory_requirement, void* state);
-void memory_system_shutdown();
-
-void* gallocate(uint64_t size, memory_tag tag);
-void gfree(void* block, uint64_t size, memory_tag tag);
-void* gzero_memory(void* block, uint64_t size);
-void* gcopy_memory(void* dest, const void* source, uint64_t size);
-void* gset_memory(void* dest, int32_t value, uint64_t size);
-
-char* get_memory_usage_str();
\ No newline at end of file
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../platform/platform.h"
+
+typedef enum memory_tag {
+	MEMORY_TAG_UNKNOWN,
+	MEMORY_TAG_ARRAY,
+	MEMORY_TAG_DARRAY,
+	MEMORY_TAG_DICT,
+	MEMORY_TAG_RING_QUEUE,
+	MEMORY_TAG_BST,
+	MEMORY_TAG_STRING,
+	MEMORY_TAG_APPLICATION,
+	MEMORY_TAG_JOB,
+	MEMORY_TAG_TEXTURE,
+	MEMORY_TAG_MATERIAL_INSTANCE,
+	MEMORY_TAG_RENDERER,
+	MEMORY_TAG_GAME,
+	MEMORY_TAG_TRANSFORM,
+	MEMORY_TAG_ENTITY,
+	MEMORY_TAG_ENTITY_NODE,
+	MEMORY_TAG_SCENE,
+	MEMORY_TAG_LINEAR_ALLOCATOR,
+	MEMORY_TAG_DYNAMIC_ALLOCATOR,
+	MEMORY_TAG_VIRTUAL_ARENA,
+
+	MEMORY_TAG_MAX_TAGS
+} memory_tag;
+
+typedef enum memory_flag_bits {
+	MEMORY_FLAG_NONE = 0x0,
+	// Skip the zero fill, for blocks the caller overwrites right away.
+	MEMORY_FLAG_NO_ZERO = 0x1,
+	MEMORY_FLAG_ALIGN_16 = 0x2,
+	MEMORY_FLAG_ALIGN_32 = 0x4,
+	// Cache line alignment.
+	MEMORY_FLAG_ALIGN_64 = 0x8,
+	// Page-mapped and backed by huge pages where possible. Meant for large
+	// long-lived blocks such as allocator arenas.
+	MEMORY_FLAG_HUGE_PAGES = 0x10,
+	// Served from the engine heap, a TLSF arena sized once at startup, instead
+	// of the platform heap. Falls back to the platform heap when it is full.
+	MEMORY_FLAG_LONG_LIVED = 0x20
+} memory_flag_bits;
+
+typedef uint32_t memory_flags;
+
+// What an allocation that would take a tag past its hard limit does.
+typedef enum memory_budget_policy {
+	// Logs an error and returns 0.
+	MEMORY_BUDGET_POLICY_FAIL,
+	// Logs a warning and allocates anyway.
+	MEMORY_BUDGET_POLICY_WARN,
+	// Logs a fatal error and stops in the debugger.
+	MEMORY_BUDGET_POLICY_FATAL
+} memory_budget_policy;
+
+typedef struct memory_budget {
+	// Crossing it fires EVENT_CODE_MEMORY_LOW so caches can evict. 0 disables it.
+	uint64_t soft_limit;
+	// 0 disables it.
+	uint64_t hard_limit;
+	memory_budget_policy policy;
+} memory_budget;
+
+// Threads that get their own counters. Any beyond this share one atomically
+// updated set.
+#define MEMORY_MAX_TRACKED_THREADS 64
+
+typedef struct memory_tag_stats {
+	uint64_t allocated;
+	// Highest allocated seen at a frame boundary or snapshot.
+	uint64_t peak;
+	uint64_t allocation_count;
+	uint64_t free_count;
+	// Live bytes allocated with an alignment or huge page flag.
+	uint64_t aligned;
+	uint64_t huge_pages;
+	// Running total of bytes handed out without the zero fill.
+	uint64_t no_zero;
+} memory_tag_stats;
+
+typedef struct memory_stats_snapshot {
+	uint64_t total_allocated;
+	uint64_t peak_total_allocated;
+	uint64_t allocation_count;
+	uint64_t free_count;
+	// Allocations made during the last completed frame.
+	uint64_t frame_allocation_count;
+	uint32_t thread_count;
+	memory_tag_stats tags[MEMORY_TAG_MAX_TAGS];
+} memory_stats_snapshot;
+
+// Pools that can be registered for get_memory_usage_str at the same time.
+#define MEMORY_MAX_REGISTERED_POOLS 32
+
+struct pool_allocator;
+
+typedef struct memory_system_config {
+	// Size of the engine heap backing MEMORY_FLAG_LONG_LIVED. 0 disables it.
+	uint64_t heap_size;
+	// Records a callsite and backtrace for every live allocation. Leaks are
+	// reported at shutdown. Costs a lock and a stack walk per allocation.
+	bool track_allocations;
+	// Size of the tracking table. 0 picks a default.
+	uint32_t max_tracked_allocations;
+	// When set, allocation paths are written here at shutdown.
+	const char* allocation_stacks_path;
+} memory_system_config;
+
+void memory_system_initialize(uint64_t* memory_requirement, void* state, memory_system_config* config);
+void memory_system_shutdown();
+
+// Pool allocators register themselves so their occupancy is reported.
+void memory_system_register_pool(struct pool_allocator* pool);
+void memory_system_unregister_pool(struct pool_allocator* pool);
+
+// Merges every thread's counters. Safe to call from any thread.
+void memory_system_get_stats(memory_stats_snapshot* out_snapshot);
+// Samples peaks and the per-frame allocation count. Called once at the top of each frame.
+void memory_system_begin_frame();
+
+// Tags with a budget keep one shared atomic byte count so limits are exact;
+// tags without one pay nothing. Meant to be set up at startup.
+void memory_system_set_budget(memory_tag tag, memory_budget budget);
+
+// Writes allocation paths in collapsed stack format for flame graph tools.
+// Only available with track_allocations.
+bool memory_system_write_allocation_stacks(const char* path);
+
+// Counts memory the caller maps itself, such as committed virtual pages,
+// against a tag.
+void memory_system_track_external(uint64_t size, memory_tag tag, bool allocated);
+
+// The allocation macros pass their callsite along for allocation tracking.
+void* _gallocate_flags(uint64_t size, memory_tag tag, memory_flags flags, const char* file, uint32_t line);
+
+#define gallocate(size, tag) _gallocate_flags(size, tag, MEMORY_FLAG_NONE, __FILE__, __LINE__)
+void gfree(void* block, uint64_t size, memory_tag tag);
+
+// Blocks must be freed with the same alignment and huge page flags they were
+// allocated with. MEMORY_FLAG_NO_ZERO does not matter to gfree_flags.
+#define gallocate_flags(size, tag, flags) _gallocate_flags(size, tag, flags, __FILE__, __LINE__)
+void gfree_flags(void* block, uint64_t size, memory_tag tag, memory_flags flags);
+
+// Resizes a block in place when the heap can, otherwise moves it. Bytes past
+// old_size are zeroed unless MEMORY_FLAG_NO_ZERO is set. Returns 0 and leaves
+// the old block untouched on failure. A null block allocates.
+void* _greallocate_flags(void* block, uint64_t old_size, uint64_t new_size, memory_tag tag, memory_flags flags, const char* file, uint32_t line);
+
+#define greallocate(block, old_size, new_size, tag) _greallocate_flags(block, old_size, new_size, tag, MEMORY_FLAG_NONE, __FILE__, __LINE__)
+#define greallocate_flags(block, old_size, new_size, tag, flags) _greallocate_flags(block, old_size, new_size, tag, flags, __FILE__, __LINE__)
+
+// Blocks of up to 16 bytes are handled inline with a pair of overlapping
+// moves, which covers most container element copies without a call. With a
+// constant size the branches fold away entirely.
+static inline void* gcopy_memory(void* dest, const void* source, uint64_t size) {
+	uint8_t* d = dest;
+	const uint8_t* s = source;
+	if (size > 16) {
+		return platform_copy_memory(dest, source, size);
+	}
+
+	if (size >= 8) {
+		uint64_t head, tail;
+		memcpy(&head, s, 8);
+		memcpy(&tail, s + size - 8, 8);
+		memcpy(d, &head, 8);
+		memcpy(d + size - 8, &tail, 8);
+	} else if (size >= 4) {
+		uint32_t head, tail;
+		memcpy(&head, s, 4);
+		memcpy(&tail, s + size - 4, 4);
+		memcpy(d, &head, 4);
+		memcpy(d + size - 4, &tail, 4);
+	} else if (size) {
+		uint8_t first = s[0];
+		uint8_t middle = s[size / 2];
+		uint8_t last = s[size - 1];
+		d[0] = first;
+		d[size / 2] = middle;
+		d[size - 1] = last;
+	}
+	return dest;
+}
+
+static inline void* gset_memory(void* dest, int32_t value, uint64_t size) {
+	uint8_t* d = dest;
+	if (size > 16) {
+		return platform_set_memory(dest, value, size);
+	}
+
+	uint64_t pattern = 0x0101010101010101ull * (uint8_t)value;
+	if (size >= 8) {
+		memcpy(d, &pattern, 8);
+		memcpy(d + size - 8, &pattern, 8);
+	} else if (size >= 4) {
+		memcpy(d, &pattern, 4);
+		memcpy(d + size - 4, &pattern, 4);
+	} else if (size) {
+		d[0] = (uint8_t)value;
+		d[size / 2] = (uint8_t)value;
+		d[size - 1] = (uint8_t)value;
+	}
+	return dest;
+}
+
+static inline void* gzero_memory(void* block, uint64_t size) {
+	return gset_memory(block, 0, size);
+}
+
+struct string_builder;
+
+// Appends the per-tag, heap and pool report to builder.
+void memory_system_format_usage(struct string_builder* builder);
+// The same report in a per-thread buffer, valid until the thread's next call.
+const char* get_memory_usage_str();
\ No newline at end of file
@@ -1,8 +1,34 @@
 #include "gstring.h"
 #include "gmemory.h"
+#include "logger.h"
 
+#include "../containers/hashtable.h"
+#include "../memory/linear_allocator.h"
+#include "../memory/virtual_arena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+// Address space for interned text. Only what is used gets committed.
+#define STRING_INTERN_ARENA_SIZE (64 * 1024 * 1024)
+#define STRING_INTERN_INITIAL_CAPACITY 1024
+// Changing the seed changes every id.
+#define STRING_INTERN_SEED 0x5eed0f57a1e5ull
+
+typedef struct interned_string {
+    const char* text;
+    uint64_t length;
+} interned_string;
+
+typedef struct string_intern_state {
+    platform_mutex lock;
+    virtual_arena arena;
+    // string_id to interned_string.
+    hashtable strings;
+} string_intern_state;
+
+static string_intern_state* state_ptr;
 
 uint64_t string_length(const char* str) {
     return strlen(str);
@@ -10,11 +36,377 @@ uint64_t string_length(const char* str) {
 
 char* string_duplicate(const char* str) {
     uint64_t length = string_length(str);
-    char* copy = gallocate(length + 1, MEMORY_TAG_STRING);
+    char* copy = gallocate_flags(length + 1, MEMORY_TAG_STRING, MEMORY_FLAG_NO_ZERO);
     gcopy_memory(copy, str, length + 1);
     return copy;
 }
 
-int8_t strings_equal(const char* str0, const char* str1) {
-    return strcmp(str0, str1);
-}
\ No newline at end of file
+bool strings_equal(const char* str0, const char* str1) {
+    return strcmp(str0, str1) == 0;
+}
+
+// Ids are already well mixed hashes, so the table uses them as they are.
+static uint64_t string_intern_hash_id(const void* key, uint64_t key_size) {
+    return *(const uint64_t*)key;
+}
+
+static string_id string_id_of_n(const char* str, uint64_t length) {
+    string_id id = hashtable_hash_bytes(str, length, STRING_INTERN_SEED);
+    return id == STRING_ID_INVALID ? 1 : id;
+}
+
+bool string_intern_system_initialize(uint64_t* memory_requirement, void* state) {
+    *memory_requirement = sizeof(string_intern_state);
+    if (state == 0) {
+        return true;
+    }
+
+    state_ptr = state;
+    gzero_memory(state_ptr, sizeof(string_intern_state));
+    if (!platform_mutex_create(&state_ptr->lock)) {
+        KERROR("string_intern_system_initialize - failed to create lock.");
+        return false;
+    }
+    if (!virtual_arena_create(STRING_INTERN_ARENA_SIZE, 0, &state_ptr->arena)) {
+        KERROR("string_intern_system_initialize - failed to reserve the string arena.");
+        return false;
+    }
+    if (!hashtable_create_custom(sizeof(string_id), sizeof(interned_string), STRING_INTERN_INITIAL_CAPACITY,
+            string_intern_hash_id, 0, &state_ptr->strings)) {
+        KERROR("string_intern_system_initialize - failed to create the string table.");
+        return false;
+    }
+    return true;
+}
+
+void string_intern_system_shutdown(void* state) {
+    if (state_ptr) {
+        hashtable_destroy(&state_ptr->strings);
+        virtual_arena_destroy(&state_ptr->arena);
+        platform_mutex_destroy(&state_ptr->lock);
+    }
+    state_ptr = 0;
+}
+
+string_id string_intern_n(const char* str, uint64_t length) {
+    if (!state_ptr || !str) {
+        return STRING_ID_INVALID;
+    }
+
+    string_id id = string_id_of_n(str, length);
+    platform_mutex_lock(&state_ptr->lock);
+    bool inserted = false;
+    interned_string* entry = hashtable_emplace(&state_ptr->strings, &id, &inserted);
+    if (!entry) {
+        platform_mutex_unlock(&state_ptr->lock);
+        return STRING_ID_INVALID;
+    }
+
+    if (inserted) {
+        char* text = virtual_arena_allocate(&state_ptr->arena, length + 1);
+        if (!text) {
+            hashtable_remove(&state_ptr->strings, &id, 0);
+            platform_mutex_unlock(&state_ptr->lock);
+            KERROR("string_intern - string arena is full.");
+            return STRING_ID_INVALID;
+        }
+        gcopy_memory(text, str, length);
+        text[length] = 0;
+        entry->text = text;
+        entry->length = length;
+    } else if (entry->length != length || memcmp(entry->text, str, length) != 0) {
+        platform_mutex_unlock(&state_ptr->lock);
+        KERROR("string_intern - '%.*s' collides with '%s'.", (int)length, str, entry->text);
+        return STRING_ID_INVALID;
+    }
+    platform_mutex_unlock(&state_ptr->lock);
+    return id;
+}
+
+string_id string_intern(const char* str) {
+    return str ? string_intern_n(str, string_length(str)) : STRING_ID_INVALID;
+}
+
+string_id string_id_of(const char* str) {
+    return str ? string_id_of_n(str, string_length(str)) : STRING_ID_INVALID;
+}
+
+const char* string_id_text(string_id id) {
+    if (!state_ptr) {
+        return 0;
+    }
+    platform_mutex_lock(&state_ptr->lock);
+    interned_string* entry = hashtable_find(&state_ptr->strings, &id);
+    const char* text = entry ? entry->text : 0;
+    platform_mutex_unlock(&state_ptr->lock);
+    return text;
+}
+
+string_view string_view_from_cstr(const char* str) {
+    return string_view_create(str, str ? string_length(str) : 0);
+}
+
+bool string_view_equals(string_view a, string_view b) {
+    return a.length == b.length && (a.length == 0 || memcmp(a.data, b.data, a.length) == 0);
+}
+
+bool string_view_equals_cstr(string_view a, const char* b) {
+    return string_view_equals(a, string_view_from_cstr(b));
+}
+
+int32_t string_view_compare(string_view a, string_view b) {
+    uint64_t shared = a.length < b.length ? a.length : b.length;
+    int32_t result = shared ? memcmp(a.data, b.data, shared) : 0;
+    if (result != 0) {
+        return result;
+    }
+    return a.length < b.length ? -1 : a.length > b.length;
+}
+
+bool string_view_starts_with(string_view view, string_view prefix) {
+    return prefix.length <= view.length && string_view_equals(string_view_create(view.data, prefix.length), prefix);
+}
+
+bool string_view_ends_with(string_view view, string_view suffix) {
+    return suffix.length <= view.length &&
+        string_view_equals(string_view_create(view.data + view.length - suffix.length, suffix.length), suffix);
+}
+
+string_view string_view_substring(string_view view, uint64_t start, uint64_t length) {
+    if (start >= view.length) {
+        return string_view_create(view.data + view.length, 0);
+    }
+    uint64_t left = view.length - start;
+    return string_view_create(view.data + start, length < left ? length : left);
+}
+
+static bool string_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+string_view string_view_trim(string_view view) {
+    while (view.length && string_is_space(view.data[0])) {
+        view.data++;
+        view.length--;
+    }
+    while (view.length && string_is_space(view.data[view.length - 1])) {
+        view.length--;
+    }
+    return view;
+}
+
+uint64_t string_view_find(string_view view, char c) {
+    const char* found = view.length ? memchr(view.data, c, view.length) : 0;
+    return found ? (uint64_t)(found - view.data) : STRING_VIEW_NOT_FOUND;
+}
+
+uint64_t string_view_find_last(string_view view, char c) {
+    for (uint64_t i = view.length; i > 0; --i) {
+        if (view.data[i - 1] == c) {
+            return i - 1;
+        }
+    }
+    return STRING_VIEW_NOT_FOUND;
+}
+
+bool string_view_split(string_view* remaining, char delimiter, string_view* out_token) {
+    if (!remaining->data) {
+        return false;
+    }
+
+    uint64_t index = string_view_find(*remaining, delimiter);
+    if (index == STRING_VIEW_NOT_FOUND) {
+        *out_token = *remaining;
+        // The last token is handed out even when empty, then the walk ends.
+        remaining->data = 0;
+        remaining->length = 0;
+        return true;
+    }
+
+    *out_token = string_view_create(remaining->data, index);
+    remaining->data += index + 1;
+    remaining->length -= index + 1;
+    return true;
+}
+
+bool string_view_parse_u64(string_view view, uint64_t* out_value) {
+    if (view.length == 0) {
+        return false;
+    }
+
+    uint64_t value = 0;
+    for (uint64_t i = 0; i < view.length; ++i) {
+        char c = view.data[i];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        uint64_t digit = (uint64_t)(c - '0');
+        if (value > (UINT64_MAX - digit) / 10) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    *out_value = value;
+    return true;
+}
+
+bool string_view_parse_i64(string_view view, int64_t* out_value) {
+    bool negative = view.length && view.data[0] == '-';
+    if (view.length && (view.data[0] == '-' || view.data[0] == '+')) {
+        view = string_view_substring(view, 1, view.length);
+    }
+
+    uint64_t magnitude;
+    if (!string_view_parse_u64(view, &magnitude)) {
+        return false;
+    }
+    if (negative) {
+        if (magnitude > (uint64_t)INT64_MAX + 1) {
+            return false;
+        }
+        *out_value = (int64_t)(0 - magnitude);
+    } else {
+        if (magnitude > INT64_MAX) {
+            return false;
+        }
+        *out_value = (int64_t)magnitude;
+    }
+    return true;
+}
+
+bool string_view_parse_f64(string_view view, double* out_value) {
+    // strtod needs a terminator, so go through a small stack copy.
+    char text[64];
+    if (view.length == 0 || view.length >= sizeof(text) || string_is_space(view.data[0])) {
+        return false;
+    }
+    gcopy_memory(text, view.data, view.length);
+    text[view.length] = 0;
+
+    char* end;
+    double value = strtod(text, &end);
+    if (end != text + view.length) {
+        return false;
+    }
+    *out_value = value;
+    return true;
+}
+
+string_id string_intern_view(string_view view) {
+    return view.data ? string_intern_n(view.data, view.length) : STRING_ID_INVALID;
+}
+
+void string_builder_init_buffer(string_builder* builder, char* buffer, uint64_t capacity) {
+    builder->buffer = buffer;
+    builder->length = 0;
+    builder->capacity = capacity;
+    builder->arena = 0;
+    builder->truncated = false;
+    buffer[0] = 0;
+}
+
+bool string_builder_init_arena(string_builder* builder, struct linear_allocator* arena, uint64_t initial_capacity) {
+    if (initial_capacity < 64) {
+        initial_capacity = 64;
+    }
+    char* buffer = linear_allocator_allocate(arena, initial_capacity);
+    if (!buffer) {
+        KERROR("string_builder_init_arena - arena cannot hold %lluB.", initial_capacity);
+        return false;
+    }
+    string_builder_init_buffer(builder, buffer, initial_capacity);
+    builder->arena = arena;
+    return true;
+}
+
+// Makes room for capacity bytes. Only arena builders can grow.
+static bool string_builder_grow(string_builder* builder, uint64_t capacity) {
+    linear_allocator* arena = builder->arena;
+    if (!arena) {
+        return false;
+    }
+    if (capacity < builder->capacity * 2) {
+        capacity = builder->capacity * 2;
+    }
+
+    if (linear_allocator_try_extend(arena, builder->buffer, builder->capacity, capacity)) {
+        builder->capacity = capacity;
+        return true;
+    }
+
+    char* buffer = linear_allocator_allocate(arena, capacity);
+    if (!buffer) {
+        return false;
+    }
+    gcopy_memory(buffer, builder->buffer, builder->length + 1);
+    builder->buffer = buffer;
+    builder->capacity = capacity;
+    return true;
+}
+
+bool string_builder_append(string_builder* builder, string_view view) {
+    uint64_t length = view.length;
+    if (builder->length + length + 1 > builder->capacity && !string_builder_grow(builder, builder->length + length + 1)) {
+        length = builder->capacity - 1 - builder->length;
+        builder->truncated = true;
+    }
+    gcopy_memory(builder->buffer + builder->length, view.data, length);
+    builder->length += length;
+    builder->buffer[builder->length] = 0;
+    return length == view.length;
+}
+
+bool string_builder_append_cstr(string_builder* builder, const char* str) {
+    return string_builder_append(builder, string_view_from_cstr(str));
+}
+
+bool string_builder_append_char(string_builder* builder, char c) {
+    if (builder->length + 2 > builder->capacity && !string_builder_grow(builder, builder->length + 2)) {
+        builder->truncated = true;
+        return false;
+    }
+    builder->buffer[builder->length++] = c;
+    builder->buffer[builder->length] = 0;
+    return true;
+}
+
+bool string_builder_appendv(string_builder* builder, const char* format, va_list args) {
+    va_list first;
+    va_copy(first, args);
+    uint64_t room = builder->capacity - builder->length;
+    int32_t written = vsnprintf(builder->buffer + builder->length, room, format, first);
+    va_end(first);
+    if (written < 0) {
+        builder->buffer[builder->length] = 0;
+        return false;
+    }
+
+    if ((uint64_t)written < room) {
+        builder->length += (uint64_t)written;
+        return true;
+    }
+    if (string_builder_grow(builder, builder->length + (uint64_t)written + 1)) {
+        vsnprintf(builder->buffer + builder->length, builder->capacity - builder->length, format, args);
+        builder->length += (uint64_t)written;
+        return true;
+    }
+
+    // vsnprintf already wrote as much as fits.
+    builder->length = builder->capacity - 1;
+    builder->truncated = true;
+    return false;
+}
+
+bool string_builder_appendf(string_builder* builder, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    bool result = string_builder_appendv(builder, format, args);
+    va_end(args);
+    return result;
+}
+
+void string_builder_reset(string_builder* builder) {
+    builder->length = 0;
+    builder->truncated = false;
+    builder->buffer[0] = 0;
+}
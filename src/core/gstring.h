@@ -1,8 +1,106 @@
 #pragma once
 
+#include <stdarg.h>
+#include <stdbool.h>
 #include <stdint.h>
 
+struct linear_allocator;
+
 uint64_t string_length(const char* str);
 char* string_duplicate(const char* str);
 
-int8_t strings_equal(const char* str0, const char* str1);
\ No newline at end of file
+// True when both strings hold the same text.
+bool strings_equal(const char* str0, const char* str1);
+
+// Interned strings are named by a 64-bit hash of their text, so comparing two
+// names is one integer compare. The text is copied once into an arena and
+// stays valid until shutdown. Safe to call from any thread.
+typedef uint64_t string_id;
+
+#define STRING_ID_INVALID 0
+
+bool string_intern_system_initialize(uint64_t* memory_requirement, void* state);
+void string_intern_system_shutdown(void* state);
+
+string_id string_intern(const char* str);
+string_id string_intern_n(const char* str, uint64_t length);
+// The id str would be interned under, without storing it. Ids are stable
+// across runs, so they can be computed ahead of time or saved.
+string_id string_id_of(const char* str);
+// Text of an interned string, or 0 when the id was never interned.
+const char* string_id_text(string_id id);
+
+// A run of characters inside someone else's string. Not null terminated and
+// never owns its memory, so slicing, trimming and splitting are free.
+typedef struct string_view {
+    const char* data;
+    uint64_t length;
+} string_view;
+
+#define STRING_VIEW_NOT_FOUND UINT64_MAX
+// Only for string literals.
+#define STRING_VIEW_LITERAL(literal) ((string_view){(literal), sizeof(literal) - 1})
+
+static inline string_view string_view_create(const char* data, uint64_t length) {
+    string_view view = {data, length};
+    return view;
+}
+
+string_view string_view_from_cstr(const char* str);
+
+bool string_view_equals(string_view a, string_view b);
+bool string_view_equals_cstr(string_view a, const char* b);
+// Byte order, like strcmp.
+int32_t string_view_compare(string_view a, string_view b);
+bool string_view_starts_with(string_view view, string_view prefix);
+bool string_view_ends_with(string_view view, string_view suffix);
+
+// Clamped to the view, so out of range requests give a shorter or empty view.
+string_view string_view_substring(string_view view, uint64_t start, uint64_t length);
+// Drops leading and trailing whitespace.
+string_view string_view_trim(string_view view);
+uint64_t string_view_find(string_view view, char c);
+uint64_t string_view_find_last(string_view view, char c);
+
+// Takes the text up to the next delimiter off the front of remaining. Returns
+// false once nothing is left. Walk every token with:
+// while (string_view_split(&remaining, ',', &token)) { ... }
+bool string_view_split(string_view* remaining, char delimiter, string_view* out_token);
+
+// The whole view must be the number, without surrounding whitespace.
+bool string_view_parse_i64(string_view view, int64_t* out_value);
+bool string_view_parse_u64(string_view view, uint64_t* out_value);
+bool string_view_parse_f64(string_view view, double* out_value);
+
+string_id string_intern_view(string_view view);
+
+// Builds text in a caller buffer, which truncates when full, or in a linear
+// arena, which grows in place while the builder holds its newest block. The
+// text is always null terminated.
+typedef struct string_builder {
+    char* buffer;
+    uint64_t length;
+    // Bytes in buffer, including room for the terminator.
+    uint64_t capacity;
+    struct linear_allocator* arena;
+    // Set once an append did not fit.
+    bool truncated;
+} string_builder;
+
+// capacity must be at least 1.
+void string_builder_init_buffer(string_builder* builder, char* buffer, uint64_t capacity);
+bool string_builder_init_arena(string_builder* builder, struct linear_allocator* arena, uint64_t initial_capacity);
+
+// Each returns false when the text did not fit and was cut short.
+bool string_builder_append(string_builder* builder, string_view view);
+bool string_builder_append_cstr(string_builder* builder, const char* str);
+bool string_builder_append_char(string_builder* builder, char c);
+bool string_builder_appendf(string_builder* builder, const char* format, ...);
+bool string_builder_appendv(string_builder* builder, const char* format, va_list args);
+
+static inline string_view string_builder_view(const string_builder* builder) {
+    return string_view_create(builder->buffer, builder->length);
+}
+
+// Keeps the buffer and any arena space already taken.
+void string_builder_reset(string_builder* builder);
\ No newline at end of file
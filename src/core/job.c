@@ -0,0 +1,226 @@
+#include "job.h"
+
+#include "gmemory.h"
+#include "logger.h"
+#include "../containers/ring_queue.h"
+#include "../platform/platform.h"
+
+#define JOB_QUEUE_CAPACITY 1024
+
+typedef struct job_worker {
+	uint32_t index;
+	// Physical core this worker is pinned to, or -1 when unpinned.
+	int32_t core_index;
+	platform_thread thread;
+	// Lock-free, so submitters and thieves never block each other. The owner
+	// and thieves all take the oldest job first.
+	mpmc_queue queues[JOB_PRIORITY_MAX];
+} job_worker;
+
+typedef struct job_system_state {
+	volatile int32_t running;
+	// Slot 0 belongs to the main thread, which only runs jobs from job_wait.
+	uint32_t worker_count;
+	job_worker* workers;
+	platform_semaphore work_available;
+	uint32_t reserved_core_count;
+	platform_cpu_topology topology;
+} job_system_state;
+
+static job_system_state* state_ptr;
+
+// Threads that are not workers submit through the main thread's queue.
+static _Thread_local uint32_t thread_worker_index = 0;
+
+static bool job_find(uint32_t worker_index, job_info* out_job) {
+	for (uint32_t priority = 0; priority < JOB_PRIORITY_MAX; ++priority) {
+		if (mpmc_queue_pop(&state_ptr->workers[worker_index].queues[priority], out_job)) {
+			return true;
+		}
+
+		for (uint32_t i = 1; i < state_ptr->worker_count; ++i) {
+			uint32_t victim = (worker_index + i) % state_ptr->worker_count;
+			if (mpmc_queue_pop(&state_ptr->workers[victim].queues[priority], out_job)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+static void job_execute(job_info* job) {
+	job->entry_point(job->param_data);
+	if (job->counter) {
+		platform_atomic_add_i32(&job->counter->value, -1);
+	}
+}
+
+static uint32_t job_worker_thread_run(void* params) {
+	job_worker* worker = params;
+	thread_worker_index = worker->index;
+
+	while (platform_atomic_load_i32(&state_ptr->running)) {
+		job_info job;
+		if (job_find(worker->index, &job)) {
+			job_execute(&job);
+		} else {
+			platform_semaphore_wait(&state_ptr->work_available);
+		}
+	}
+
+	return 0;
+}
+
+bool job_system_initialize(uint64_t* memory_requirement, void* state, job_system_config* config) {
+	*memory_requirement = sizeof(job_system_state);
+	if (state == 0) {
+		return true;
+	}
+
+	state_ptr = state;
+	gzero_memory(state_ptr, sizeof(job_system_state));
+
+	if (!platform_get_cpu_topology(&state_ptr->topology)) {
+		KWARN("job_system_initialize - could not read cpu topology, workers will not be pinned.");
+	}
+
+	uint32_t core_count = state_ptr->topology.physical_core_count;
+	state_ptr->reserved_core_count = config->reserved_core_count < core_count ? config->reserved_core_count : core_count;
+
+	// Without enough cores left over, fall back to a single unpinned worker.
+	uint32_t free_core_count = core_count - state_ptr->reserved_core_count;
+	bool pin_workers = config->pin_workers && free_core_count > 0;
+	uint32_t thread_count = free_core_count > 0 ? free_core_count : 1;
+	if (config->max_worker_count > 0 && thread_count > config->max_worker_count) {
+		thread_count = config->max_worker_count;
+	}
+
+	state_ptr->worker_count = thread_count + 1;
+	state_ptr->workers = gallocate_flags(sizeof(job_worker) * state_ptr->worker_count, MEMORY_TAG_JOB, MEMORY_FLAG_LONG_LIVED | MEMORY_FLAG_ALIGN_64);
+	state_ptr->running = 1;
+	thread_worker_index = 0;
+
+	if (!platform_semaphore_create(0, &state_ptr->work_available)) {
+		KERROR("job_system_initialize - failed to create work semaphore.");
+		return false;
+	}
+
+	for (uint32_t i = 0; i < state_ptr->worker_count; ++i) {
+		state_ptr->workers[i].index = i;
+		state_ptr->workers[i].core_index = -1;
+		for (uint32_t p = 0; p < JOB_PRIORITY_MAX; ++p) {
+			if (!mpmc_queue_create(sizeof(job_info), JOB_QUEUE_CAPACITY, &state_ptr->workers[i].queues[p])) {
+				KERROR("job_system_initialize - failed to create job queue.");
+				return false;
+			}
+		}
+	}
+
+	for (uint32_t i = 1; i < state_ptr->worker_count; ++i) {
+		job_worker* worker = &state_ptr->workers[i];
+		if (!platform_thread_create(job_worker_thread_run, worker, &worker->thread)) {
+			KFATAL("job_system_initialize - failed to start worker thread %u.", i);
+			return false;
+		}
+
+		if (pin_workers) {
+			worker->core_index = state_ptr->reserved_core_count + (i - 1);
+			platform_cpu_core* core = &state_ptr->topology.cores[worker->core_index];
+			platform_thread_set_affinity(&worker->thread, core->logical_processors, core->logical_count);
+		}
+	}
+
+	KINFO("Job system started %u worker threads on %u physical cores (%u reserved, %u logical processors).",
+		thread_count, core_count, state_ptr->reserved_core_count, state_ptr->topology.logical_processor_count);
+	return true;
+}
+
+void job_system_shutdown(void* state) {
+	if (!state_ptr) {
+		return;
+	}
+
+	platform_atomic_store_i32(&state_ptr->running, 0);
+	platform_semaphore_signal(&state_ptr->work_available, state_ptr->worker_count);
+
+	for (uint32_t i = 1; i < state_ptr->worker_count; ++i) {
+		platform_thread_join(&state_ptr->workers[i].thread);
+	}
+
+	for (uint32_t i = 0; i < state_ptr->worker_count; ++i) {
+		for (uint32_t p = 0; p < JOB_PRIORITY_MAX; ++p) {
+			mpmc_queue_destroy(&state_ptr->workers[i].queues[p]);
+		}
+	}
+
+	platform_semaphore_destroy(&state_ptr->work_available);
+	gfree_flags(state_ptr->workers, sizeof(job_worker) * state_ptr->worker_count, MEMORY_TAG_JOB, MEMORY_FLAG_LONG_LIVED | MEMORY_FLAG_ALIGN_64);
+	state_ptr = 0;
+}
+
+job_info job_create(pfn_job_entry entry_point, void* param_data, job_priority priority) {
+	job_info job;
+	job.entry_point = entry_point;
+	job.param_data = param_data;
+	job.priority = priority;
+	job.counter = 0;
+	return job;
+}
+
+void job_submit(job_info* jobs, uint32_t job_count, job_counter* counter) {
+	if (counter) {
+		platform_atomic_add_i32(&counter->value, (int32_t)job_count);
+	}
+
+	if (!state_ptr) {
+		for (uint32_t i = 0; i < job_count; ++i) {
+			jobs[i].counter = counter;
+			job_execute(&jobs[i]);
+		}
+		return;
+	}
+
+	job_worker* worker = &state_ptr->workers[thread_worker_index];
+	uint32_t queued = 0;
+	for (uint32_t i = 0; i < job_count; ++i) {
+		jobs[i].counter = counter;
+		if (mpmc_queue_push(&worker->queues[jobs[i].priority], &jobs[i])) {
+			queued++;
+		} else {
+			// Queue is full, run it here rather than drop it.
+			job_execute(&jobs[i]);
+		}
+	}
+
+	if (queued) {
+		platform_semaphore_signal(&state_ptr->work_available, queued);
+	}
+}
+
+void job_wait(job_counter* counter) {
+	while (platform_atomic_load_i32(&counter->value) > 0) {
+		job_info job;
+		if (state_ptr && job_find(thread_worker_index, &job)) {
+			job_execute(&job);
+		} else {
+			platform_thread_yield();
+		}
+	}
+}
+
+bool job_system_pin_to_reserved_core(uint32_t reserved_index) {
+	if (!state_ptr || reserved_index >= state_ptr->reserved_core_count) {
+		return false;
+	}
+
+	platform_cpu_core* core = &state_ptr->topology.cores[reserved_index];
+	return platform_current_thread_set_affinity(core->logical_processors, core->logical_count);
+}
+
+bool job_counter_done(job_counter* counter) {
+	return platform_atomic_load_i32(&counter->value) <= 0;
+}
+
+uint32_t job_system_worker_count() {
+	return state_ptr ? state_ptr->worker_count - 1 : 0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef void (*pfn_job_entry)(void* param_data);
+
+typedef enum job_priority {
+	JOB_PRIORITY_HIGH,
+	JOB_PRIORITY_NORMAL,
+	JOB_PRIORITY_LOW,
+	JOB_PRIORITY_MAX
+} job_priority;
+
+// Number of submitted jobs still pending. Zero it before the first submit;
+// job_wait returns once every job tied to it has finished.
+typedef struct job_counter {
+	volatile int32_t value;
+} job_counter;
+
+typedef struct job_info {
+	pfn_job_entry entry_point;
+	// Owned by the caller and must stay valid until the job has run.
+	void* param_data;
+	job_priority priority;
+	job_counter* counter;
+} job_info;
+
+typedef struct job_system_config {
+	// 0 spawns one worker per physical core that is not reserved.
+	uint32_t max_worker_count;
+	// Physical cores, including their SMT siblings, that no worker may use.
+	// They are kept for latency-sensitive threads; reserved core 0 is the main thread's.
+	uint32_t reserved_core_count;
+	// Pins every worker to the logical processors of its own physical core.
+	bool pin_workers;
+} job_system_config;
+
+bool job_system_initialize(uint64_t* memory_requirement, void* state, job_system_config* config);
+void job_system_shutdown(void* state);
+
+// Pins the calling thread to the SMT siblings of one of the reserved cores.
+bool job_system_pin_to_reserved_core(uint32_t reserved_index);
+
+job_info job_create(pfn_job_entry entry_point, void* param_data, job_priority priority);
+
+void job_submit(job_info* jobs, uint32_t job_count, job_counter* counter);
+
+// Runs pending jobs on the calling thread until the counter drops to zero.
+void job_wait(job_counter* counter);
+bool job_counter_done(job_counter* counter);
+
+uint32_t job_system_worker_count();
@@ -1,56 +1,63 @@
-#include <stdarg.h>
-#include <stdio.h>
-#include <string.h>
-
-#include "asserts.h"
-#include "logger.h"
-#include "../platform/platform.h"
-
-typedef struct logger_system_state {
-	bool initialized;
-} logger_system_state;
-
-static logger_system_state* state_ptr;
-
-void report_assertion_failure(const char* expression, const char* message, const char* file, int32_t line) {
-	log_output(LOG_LEVEL_FATAL, "Assertion failure: %s, message: '%s', in file: %s, line: %d\n", expression, message, file, line);
-}
-bool initialize_logging(uint64_t* memory_requirement, void* state) {
-	*memory_requirement = sizeof(logger_system_state);
-	if (state == 0) {
-		return true;
-	}
-
-	state_ptr = state;
-	state_ptr->initialized = true;
-
-	return true;
-}
-
-void shutdown_logging() {
-	state_ptr = 0;
-}
-
-
-void log_output(log_level level, const char* message, ...) {
-	const char* level_string[6] = { "[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]:", "[TRACE]: " };
-	bool is_error = level < LOG_LEVEL_WARN;
-
-	char out_message[32000];
-	memset(out_message, 0, sizeof(out_message));
-
-	va_list arg_ptr;
-	va_start(arg_ptr, message);
-	vsnprintf(out_message, 32000, message, arg_ptr);
-	va_end(arg_ptr);
-
-	char out_message2[32000];
-	sprintf(out_message2, "%s %s\n", level_string[level], out_message);
-
-	if (is_error) {
-		platform_console_write_error(out_message2, level);
-	}
-	else {
-		platform_console_write(out_message2, level);
-	}
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "asserts.h"
+#include "gstring.h"
+#include "logger.h"
+#include "../platform/platform.h"
+
+typedef struct logger_system_state {
+	bool initialized;
+} logger_system_state;
+
+static logger_system_state* state_ptr;
+
+void report_assertion_failure(const char* expression, const char* message, const char* file, int32_t line) {
+	log_output(LOG_LEVEL_FATAL, "Assertion failure: %s, message: '%s', in file: %s, line: %d\n", expression, message, file, line);
+}
+bool initialize_logging(uint64_t* memory_requirement, void* state) {
+	*memory_requirement = sizeof(logger_system_state);
+	if (state == 0) {
+		return true;
+	}
+
+	state_ptr = state;
+	state_ptr->initialized = true;
+
+	return true;
+}
+
+void shutdown_logging() {
+	state_ptr = 0;
+}
+
+
+void log_output(log_level level, const char* message, ...) {
+	const char* level_string[6] = { "[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]:", "[TRACE]: " };
+	bool is_error = level < LOG_LEVEL_WARN;
+
+	char out_message[32000];
+	string_builder builder;
+	string_builder_init_buffer(&builder, out_message, sizeof(out_message));
+	string_builder_append_cstr(&builder, level_string[level]);
+	string_builder_append_char(&builder, ' ');
+
+	va_list arg_ptr;
+	va_start(arg_ptr, message);
+	string_builder_appendv(&builder, message, arg_ptr);
+	va_end(arg_ptr);
+
+	// Keep the line break even when the message was cut short.
+	if (builder.truncated) {
+		builder.length--;
+	}
+	string_builder_append_char(&builder, '\n');
+
+	if (is_error) {
+		platform_console_write_error(out_message, level);
+	}
+	else {
+		platform_console_write(out_message, level);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,321 @@
+#include "timer.h"
+
+#include "gmemory.h"
+#include "logger.h"
+#include "../containers/binary_heap.h"
+#include "../containers/bitset.h"
+
+#define TIMER_DEFAULT_RESOLUTION 0.001
+#define TIMER_DEFAULT_MAX_TIMERS 4096
+
+// Level 0 has one slot per tick; each level above has slots as wide as the
+// whole level below it. Together they reach 2^26 ticks, about 18 hours at 1ms.
+#define TIMER_LEVEL0_BITS 8
+#define TIMER_LEVEL_BITS 6
+#define TIMER_LEVEL_COUNT 4
+#define TIMER_LEVEL0_SLOTS (1u << TIMER_LEVEL0_BITS)
+#define TIMER_LEVEL_SLOTS (1u << TIMER_LEVEL_BITS)
+#define TIMER_SLOT_COUNT (TIMER_LEVEL0_SLOTS + (TIMER_LEVEL_COUNT - 1) * TIMER_LEVEL_SLOTS)
+#define TIMER_WHEEL_SPAN (1ull << (TIMER_LEVEL0_BITS + (TIMER_LEVEL_COUNT - 1) * TIMER_LEVEL_BITS))
+
+#define TIMER_NONE UINT32_MAX
+// Values of timer_node.list past the wheel slots.
+#define TIMER_LIST_OVERFLOW TIMER_SLOT_COUNT
+#define TIMER_LIST_FREE (TIMER_SLOT_COUNT + 1)
+
+typedef struct timer_node {
+	uint64_t expiry;
+	// Ticks between repeats, 0 for a one-shot timer.
+	uint64_t interval;
+	event_context context;
+	uint32_t prev;
+	// Also links the free list.
+	uint32_t next;
+	uint32_t generation;
+	uint16_t list;
+	uint16_t code;
+} timer_node;
+
+// Entries are not removed on cancel; a stale generation marks them dead.
+typedef struct timer_overflow_entry {
+	uint64_t expiry;
+	uint32_t index;
+	uint32_t generation;
+} timer_overflow_entry;
+
+typedef struct timer_system_state {
+	double resolution;
+	uint64_t current_tick;
+	uint32_t max_timers;
+	// Timers linked into wheel slots.
+	uint32_t wheel_count;
+	uint32_t free_head;
+	uint32_t heads[TIMER_SLOT_COUNT];
+	// Level 0 slots that hold timers, to skip empty ticks.
+	uint64_t occupied_words[BITSET_WORD_COUNT(TIMER_LEVEL0_SLOTS)];
+	bitset occupied;
+	binary_heap overflow;
+	timer_node* nodes;
+} timer_system_state;
+
+static timer_system_state* state_ptr;
+
+static int32_t timer_overflow_compare(const void* a, const void* b) {
+	uint64_t x = ((const timer_overflow_entry*)a)->expiry;
+	uint64_t y = ((const timer_overflow_entry*)b)->expiry;
+	return x < y ? -1 : x > y;
+}
+
+static uint64_t timer_to_ticks(double seconds) {
+	if (seconds <= 0) {
+		return 0;
+	}
+	// Round up so a timer never fires early.
+	uint64_t ticks = (uint64_t)(seconds / state_ptr->resolution);
+	return (double)ticks * state_ptr->resolution < seconds ? ticks + 1 : ticks;
+}
+
+static void timer_link(uint32_t index) {
+	timer_node* node = &state_ptr->nodes[index];
+	uint64_t current = state_ptr->current_tick;
+	// Only a cascade can see a timer due this very tick; it lands in the slot
+	// about to be expired.
+	if (node->expiry < current) {
+		node->expiry = current;
+	}
+
+	uint64_t delta = node->expiry - current;
+	uint32_t list;
+	if (delta < TIMER_LEVEL0_SLOTS) {
+		list = (uint32_t)(node->expiry & (TIMER_LEVEL0_SLOTS - 1));
+		bitset_set(&state_ptr->occupied, list);
+	} else if (delta < TIMER_WHEEL_SPAN) {
+		uint32_t level = 1;
+		uint32_t shift = TIMER_LEVEL0_BITS;
+		while (delta >= (1ull << (shift + TIMER_LEVEL_BITS))) {
+			level++;
+			shift += TIMER_LEVEL_BITS;
+		}
+		list = TIMER_LEVEL0_SLOTS + (level - 1) * TIMER_LEVEL_SLOTS + (uint32_t)((node->expiry >> shift) & (TIMER_LEVEL_SLOTS - 1));
+	} else {
+		timer_overflow_entry entry = {node->expiry, index, node->generation};
+		node->list = TIMER_LIST_OVERFLOW;
+		if (!binary_heap_push(&state_ptr->overflow, &entry)) {
+			KERROR("timer - failed to queue a timer %llu ticks out; it will not fire.", delta);
+		}
+		return;
+	}
+
+	node->list = (uint16_t)list;
+	node->prev = TIMER_NONE;
+	node->next = state_ptr->heads[list];
+	if (node->next != TIMER_NONE) {
+		state_ptr->nodes[node->next].prev = index;
+	}
+	state_ptr->heads[list] = index;
+	state_ptr->wheel_count++;
+}
+
+static void timer_unlink(uint32_t index) {
+	timer_node* node = &state_ptr->nodes[index];
+	if (node->list >= TIMER_SLOT_COUNT) {
+		return;
+	}
+
+	if (node->prev != TIMER_NONE) {
+		state_ptr->nodes[node->prev].next = node->next;
+	} else {
+		state_ptr->heads[node->list] = node->next;
+		if (node->next == TIMER_NONE && node->list < TIMER_LEVEL0_SLOTS) {
+			bitset_clear(&state_ptr->occupied, node->list);
+		}
+	}
+	if (node->next != TIMER_NONE) {
+		state_ptr->nodes[node->next].prev = node->prev;
+	}
+	state_ptr->wheel_count--;
+}
+
+static void timer_free(uint32_t index) {
+	timer_node* node = &state_ptr->nodes[index];
+	node->generation = node->generation + 1 ? node->generation + 1 : 1;
+	node->list = TIMER_LIST_FREE;
+	node->next = state_ptr->free_head;
+	state_ptr->free_head = index;
+}
+
+// Moves heap timers that the wheel can now reach into it.
+static void timer_migrate_overflow() {
+	const timer_overflow_entry* top;
+	while ((top = binary_heap_peek(&state_ptr->overflow)) && top->expiry - state_ptr->current_tick < TIMER_WHEEL_SPAN) {
+		timer_overflow_entry entry;
+		binary_heap_pop(&state_ptr->overflow, &entry);
+		timer_node* node = &state_ptr->nodes[entry.index];
+		if (node->generation == entry.generation && node->list == TIMER_LIST_OVERFLOW) {
+			timer_link(entry.index);
+		}
+	}
+}
+
+// Called as level 0 wraps: spreads the next slot of each level above down.
+static void timer_cascade() {
+	uint32_t shift = TIMER_LEVEL0_BITS;
+	for (uint32_t level = 1; level < TIMER_LEVEL_COUNT; ++level, shift += TIMER_LEVEL_BITS) {
+		uint32_t slot = (uint32_t)((state_ptr->current_tick >> shift) & (TIMER_LEVEL_SLOTS - 1));
+		uint32_t list = TIMER_LEVEL0_SLOTS + (level - 1) * TIMER_LEVEL_SLOTS + slot;
+		uint32_t index = state_ptr->heads[list];
+		while (index != TIMER_NONE) {
+			uint32_t next = state_ptr->nodes[index].next;
+			timer_unlink(index);
+			timer_link(index);
+			index = next;
+		}
+		// Only continue up when this level wrapped too.
+		if (slot != 0) {
+			break;
+		}
+	}
+}
+
+static void timer_expire_slot(uint32_t slot) {
+	// Rescheduled and newly scheduled timers are at least a tick out, or a
+	// whole lap for level 0, so they never land back in this slot.
+	uint32_t index;
+	while ((index = state_ptr->heads[slot]) != TIMER_NONE) {
+		timer_node* node = &state_ptr->nodes[index];
+		uint16_t code = node->code;
+		event_context context = node->context;
+		timer_unlink(index);
+		if (node->interval) {
+			node->expiry += node->interval;
+			timer_link(index);
+		} else {
+			timer_free(index);
+		}
+		// Fired last so the listener may schedule or cancel timers, this one included.
+		event_fire(code, 0, context);
+	}
+}
+
+bool timer_system_initialize(uint64_t* memory_requirement, void* state, timer_system_config* config) {
+	uint32_t max_timers = config && config->max_timers ? config->max_timers : TIMER_DEFAULT_MAX_TIMERS;
+	*memory_requirement = sizeof(timer_system_state) + sizeof(timer_node) * max_timers;
+	if (state == 0) {
+		return true;
+	}
+
+	state_ptr = state;
+	gzero_memory(state_ptr, sizeof(timer_system_state));
+	state_ptr->resolution = config && config->resolution > 0 ? config->resolution : TIMER_DEFAULT_RESOLUTION;
+	state_ptr->max_timers = max_timers;
+	state_ptr->nodes = (timer_node*)(state_ptr + 1);
+	for (uint32_t i = 0; i < TIMER_SLOT_COUNT; ++i) {
+		state_ptr->heads[i] = TIMER_NONE;
+	}
+	bitset_create(TIMER_LEVEL0_SLOTS, state_ptr->occupied_words, &state_ptr->occupied);
+
+	state_ptr->free_head = TIMER_NONE;
+	for (uint32_t i = max_timers; i-- > 0;) {
+		state_ptr->nodes[i].generation = 0;
+		timer_free(i);
+	}
+
+	if (!binary_heap_create(sizeof(timer_overflow_entry), 0, timer_overflow_compare, &state_ptr->overflow)) {
+		KERROR("timer_system_initialize - failed to create the overflow heap.");
+		return false;
+	}
+	return true;
+}
+
+void timer_system_shutdown(void* state) {
+	if (state_ptr) {
+		binary_heap_destroy(&state_ptr->overflow);
+	}
+	state_ptr = 0;
+}
+
+void timer_system_update(double time) {
+	if (!state_ptr || time <= 0) {
+		return;
+	}
+
+	uint64_t target = (uint64_t)(time / state_ptr->resolution);
+	while (state_ptr->current_tick < target) {
+		timer_migrate_overflow();
+
+		if (state_ptr->wheel_count == 0) {
+			// Nothing fires before the next heap timer comes within reach.
+			const timer_overflow_entry* top = binary_heap_peek(&state_ptr->overflow);
+			uint64_t reach = top ? top->expiry - (TIMER_WHEEL_SPAN - 1) : target;
+			state_ptr->current_tick = reach < target ? reach : target;
+			continue;
+		}
+
+		uint64_t current = state_ptr->current_tick;
+		uint64_t lap_start = current & ~(uint64_t)(TIMER_LEVEL0_SLOTS - 1);
+		uint64_t slot = bitset_find_next(&state_ptr->occupied, (current & (TIMER_LEVEL0_SLOTS - 1)) + 1);
+		if (slot != BITSET_NOT_FOUND && lap_start + slot <= target) {
+			state_ptr->current_tick = lap_start + slot;
+			timer_expire_slot((uint32_t)slot);
+			continue;
+		}
+
+		uint64_t next_lap = lap_start + TIMER_LEVEL0_SLOTS;
+		if (next_lap > target) {
+			state_ptr->current_tick = target;
+			break;
+		}
+		state_ptr->current_tick = next_lap;
+		timer_cascade();
+		timer_expire_slot(0);
+	}
+}
+
+timer_handle timer_schedule(double delay, double interval, uint16_t code, event_context context) {
+	if (!state_ptr) {
+		return TIMER_HANDLE_INVALID;
+	}
+	if (state_ptr->free_head == TIMER_NONE) {
+		KERROR("timer_schedule - all %u timers are in use.", state_ptr->max_timers);
+		return TIMER_HANDLE_INVALID;
+	}
+
+	uint32_t index = state_ptr->free_head;
+	timer_node* node = &state_ptr->nodes[index];
+	state_ptr->free_head = node->next;
+
+	uint64_t delay_ticks = timer_to_ticks(delay);
+	node->expiry = state_ptr->current_tick + (delay_ticks ? delay_ticks : 1);
+	node->interval = timer_to_ticks(interval);
+	if (interval > 0 && node->interval == 0) {
+		node->interval = 1;
+	}
+	node->context = context;
+	node->code = code;
+	timer_link(index);
+
+	timer_handle handle = {index, node->generation};
+	return handle;
+}
+
+static timer_node* timer_get(timer_handle handle) {
+	if (!state_ptr || handle.index >= state_ptr->max_timers) {
+		return 0;
+	}
+	timer_node* node = &state_ptr->nodes[handle.index];
+	return node->generation == handle.generation && node->list != TIMER_LIST_FREE ? node : 0;
+}
+
+bool timer_cancel(timer_handle handle) {
+	if (!timer_get(handle)) {
+		return false;
+	}
+	// A timer in the overflow heap leaves a dead entry behind.
+	timer_unlink(handle.index);
+	timer_free(handle.index);
+	return true;
+}
+
+bool timer_is_active(timer_handle handle) {
+	return timer_get(handle) != 0;
+}
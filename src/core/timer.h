@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "event.h"
+
+// Timers that fire an event after a delay, optionally repeating. They live in
+// a hierarchical timing wheel ticked by the application clock, so scheduling
+// and cancelling are O(1) and a frame only touches the slots that expire.
+// Timers further out than the wheel reaches wait in a binary heap.
+// Main thread only.
+
+typedef struct timer_handle {
+	uint32_t index;
+	uint32_t generation;
+} timer_handle;
+
+// Generations start at 1, so a zeroed handle is never active.
+#define TIMER_HANDLE_INVALID ((timer_handle){0, 0})
+
+typedef struct timer_system_config {
+	// Seconds per tick. 0 uses 1ms.
+	double resolution;
+	// Timers alive at once. 0 uses 4096.
+	uint32_t max_timers;
+} timer_system_config;
+
+bool timer_system_initialize(uint64_t* memory_requirement, void* state, timer_system_config* config);
+void timer_system_shutdown(void* state);
+
+// Advances to time, in seconds on the application clock, firing every timer
+// that expired on the way in expiry order.
+void timer_system_update(double time);
+
+// Fires code with context once delay seconds after the last update, then
+// every interval seconds while interval is above 0. The event is fired with a
+// 0 sender; EVENT_CODE_TIMER is free for timers that need no code of their own.
+timer_handle timer_schedule(double delay, double interval, uint16_t code, event_context context);
+// False when the timer already fired for the last time or was cancelled.
+bool timer_cancel(timer_handle handle);
+bool timer_is_active(timer_handle handle);
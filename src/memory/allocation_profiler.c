@@ -0,0 +1,215 @@
+#include "allocation_profiler.h"
+
+#include "../core/logger.h"
+
+#include <stdio.h>
+
+#define ALLOCATION_PROFILER_STACK_CAPACITY 16384
+// Skips the profiler hook and _gallocate_flags itself.
+#define ALLOCATION_PROFILER_SKIP_FRAMES 2
+
+static uint64_t allocation_profiler_hash_pointer(const void* block) {
+    return ((uint64_t)block >> 4) * 0x9E3779B97F4A7C15ull;
+}
+
+static uint64_t allocation_profiler_hash_bytes(uint64_t hash, const void* data, uint64_t size) {
+    const uint8_t* bytes = data;
+    for (uint64_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+bool allocation_profiler_create(uint32_t max_live_allocations, allocation_profiler* out_profiler) {
+    gzero_memory(out_profiler, sizeof(allocation_profiler));
+
+    // Keep the record table at most half full so probes stay short.
+    uint32_t capacity = 1024;
+    while (capacity < max_live_allocations * 2) {
+        capacity <<= 1;
+    }
+    out_profiler->record_capacity = capacity;
+    out_profiler->stack_capacity = ALLOCATION_PROFILER_STACK_CAPACITY;
+    out_profiler->records = platform_allocate_pages(sizeof(allocation_record) * out_profiler->record_capacity, false);
+    out_profiler->stacks = platform_allocate_pages(sizeof(allocation_stack) * out_profiler->stack_capacity, false);
+    if (!out_profiler->records || !out_profiler->stacks) {
+        KERROR("allocation_profiler_create - failed to map tables for %u live allocations.", max_live_allocations);
+        allocation_profiler_destroy(out_profiler);
+        return false;
+    }
+
+    platform_mutex_create(&out_profiler->lock);
+    return true;
+}
+
+void allocation_profiler_destroy(allocation_profiler* profiler) {
+    if (profiler->records || profiler->stacks) {
+        platform_free_pages(profiler->records, sizeof(allocation_record) * profiler->record_capacity, false);
+        platform_free_pages(profiler->stacks, sizeof(allocation_stack) * profiler->stack_capacity, false);
+        if (profiler->lock.internal_data) {
+            platform_mutex_destroy(&profiler->lock);
+        }
+    }
+    gzero_memory(profiler, sizeof(allocation_profiler));
+}
+
+// Expects the lock to be held. Returns the stack's index, or -1 when the table is full.
+static int32_t allocation_profiler_find_stack(allocation_profiler* profiler, const char* file, uint32_t line, void** frames, uint32_t frame_count) {
+    uint64_t hash = allocation_profiler_hash_bytes(0xCBF29CE484222325ull, &file, sizeof(file));
+    hash = allocation_profiler_hash_bytes(hash, &line, sizeof(line));
+    hash = allocation_profiler_hash_bytes(hash, frames, sizeof(void*) * frame_count);
+
+    uint32_t mask = profiler->stack_capacity - 1;
+    for (uint32_t i = (uint32_t)hash & mask;; i = (i + 1) & mask) {
+        allocation_stack* stack = &profiler->stacks[i];
+        if (stack->file == 0) {
+            if (profiler->stack_count >= profiler->stack_capacity - profiler->stack_capacity / 8) {
+                return -1;
+            }
+            stack->hash = hash;
+            stack->file = file;
+            stack->line = line;
+            stack->frame_count = frame_count;
+            gcopy_memory(stack->frames, frames, sizeof(void*) * frame_count);
+            profiler->stack_count++;
+            return (int32_t)i;
+        }
+
+        if (stack->hash == hash && stack->file == file && stack->line == line && stack->frame_count == frame_count) {
+            bool same = true;
+            for (uint32_t f = 0; f < frame_count && same; ++f) {
+                same = stack->frames[f] == frames[f];
+            }
+            if (same) {
+                return (int32_t)i;
+            }
+        }
+    }
+}
+
+void allocation_profiler_on_allocate(allocation_profiler* profiler, void* block, uint64_t size, memory_tag tag, const char* file, uint32_t line) {
+    void* frames[ALLOCATION_PROFILER_MAX_FRAMES];
+    uint32_t frame_count = platform_capture_backtrace(frames, ALLOCATION_PROFILER_MAX_FRAMES, ALLOCATION_PROFILER_SKIP_FRAMES);
+
+    platform_mutex_lock(&profiler->lock);
+    int32_t stack_index = allocation_profiler_find_stack(profiler, file, line, frames, frame_count);
+    if (stack_index < 0 || profiler->record_count >= profiler->record_capacity / 2) {
+        profiler->dropped_count++;
+        platform_mutex_unlock(&profiler->lock);
+        return;
+    }
+
+    allocation_stack* stack = &profiler->stacks[stack_index];
+    stack->allocation_count++;
+    stack->allocated_bytes += size;
+    stack->live_count++;
+    stack->live_bytes += size;
+
+    uint32_t mask = profiler->record_capacity - 1;
+    uint32_t i = (uint32_t)allocation_profiler_hash_pointer(block) & mask;
+    while (profiler->records[i].block) {
+        i = (i + 1) & mask;
+    }
+    profiler->records[i].block = block;
+    profiler->records[i].size = size;
+    profiler->records[i].tag = tag;
+    profiler->records[i].stack_index = (uint32_t)stack_index;
+    profiler->record_count++;
+    platform_mutex_unlock(&profiler->lock);
+}
+
+void allocation_profiler_on_free(allocation_profiler* profiler, void* block) {
+    platform_mutex_lock(&profiler->lock);
+    uint32_t mask = profiler->record_capacity - 1;
+    uint32_t i = (uint32_t)allocation_profiler_hash_pointer(block) & mask;
+    while (profiler->records[i].block && profiler->records[i].block != block) {
+        i = (i + 1) & mask;
+    }
+
+    // Blocks from before tracking started, or that were dropped, are not found.
+    if (!profiler->records[i].block) {
+        platform_mutex_unlock(&profiler->lock);
+        return;
+    }
+
+    allocation_stack* stack = &profiler->stacks[profiler->records[i].stack_index];
+    stack->live_count--;
+    stack->live_bytes -= profiler->records[i].size;
+    profiler->record_count--;
+
+    // Backward shift deletion: pull later entries of the probe run into the
+    // hole so lookups never need tombstones.
+    for (uint32_t j = (i + 1) & mask; profiler->records[j].block; j = (j + 1) & mask) {
+        uint32_t home = (uint32_t)allocation_profiler_hash_pointer(profiler->records[j].block) & mask;
+        bool movable = i <= j ? (home <= i || home > j) : (home <= i && home > j);
+        if (movable) {
+            profiler->records[i] = profiler->records[j];
+            i = j;
+        }
+    }
+    profiler->records[i].block = 0;
+    platform_mutex_unlock(&profiler->lock);
+}
+
+void allocation_profiler_on_frame(allocation_profiler* profiler) {
+    platform_mutex_lock(&profiler->lock);
+    profiler->frame_count++;
+    platform_mutex_unlock(&profiler->lock);
+}
+
+uint64_t allocation_profiler_report_leaks(allocation_profiler* profiler) {
+    platform_mutex_lock(&profiler->lock);
+    uint64_t leaked_bytes = 0;
+    for (uint32_t i = 0; i < profiler->stack_capacity; ++i) {
+        allocation_stack* stack = &profiler->stacks[i];
+        if (!stack->file || !stack->live_count) {
+            continue;
+        }
+
+        leaked_bytes += stack->live_bytes;
+        KWARN("Leak: %llu blocks, %lluB allocated at %s:%u", stack->live_count, stack->live_bytes, stack->file, stack->line);
+        for (uint32_t f = 0; f < stack->frame_count; ++f) {
+            char name[256];
+            platform_describe_address(stack->frames[f], name, sizeof(name));
+            KWARN("    %s", name);
+        }
+    }
+
+    if (profiler->record_count) {
+        KWARN("%u allocations (%lluB) were never freed.", profiler->record_count, leaked_bytes);
+    }
+    if (profiler->dropped_count) {
+        KWARN("%llu allocations were not tracked because the profiler tables were full.", profiler->dropped_count);
+    }
+    platform_mutex_unlock(&profiler->lock);
+    return leaked_bytes;
+}
+
+bool allocation_profiler_write_collapsed_stacks(allocation_profiler* profiler, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        KERROR("allocation_profiler_write_collapsed_stacks - could not open '%s' for writing.", path);
+        return false;
+    }
+
+    platform_mutex_lock(&profiler->lock);
+    for (uint32_t i = 0; i < profiler->stack_capacity; ++i) {
+        allocation_stack* stack = &profiler->stacks[i];
+        if (!stack->file || !stack->allocation_count) {
+            continue;
+        }
+
+        // Outermost frame first.
+        for (uint32_t f = stack->frame_count; f > 0; --f) {
+            char name[256];
+            platform_describe_function(stack->frames[f - 1], name, sizeof(name));
+            fprintf(file, "%s;", name);
+        }
+        fprintf(file, "%s:%u %llu\n", stack->file, stack->line, (unsigned long long)stack->allocated_bytes);
+    }
+    KINFO("Wrote %u allocation paths over %llu frames to '%s'.", profiler->stack_count, profiler->frame_count, path);
+    platform_mutex_unlock(&profiler->lock);
+
+    fclose(file);
+    return true;
+}
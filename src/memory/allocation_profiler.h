@@ -0,0 +1,60 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../core/gmemory.h"
+#include "../platform/platform.h"
+
+#define ALLOCATION_PROFILER_MAX_FRAMES 16
+
+// Unique allocation path: the callsite plus the stack above it.
+typedef struct allocation_stack {
+    uint64_t hash;
+    const char* file;
+    uint32_t line;
+    uint32_t frame_count;
+    void* frames[ALLOCATION_PROFILER_MAX_FRAMES];
+    uint64_t allocation_count;
+    uint64_t allocated_bytes;
+    uint64_t live_count;
+    uint64_t live_bytes;
+} allocation_stack;
+
+typedef struct allocation_record {
+    void* block;
+    uint64_t size;
+    memory_tag tag;
+    uint32_t stack_index;
+} allocation_record;
+
+// Records every live allocation in open-addressed tables that are mapped
+// straight from the OS, so the profiler never allocates through gmemory.
+typedef struct allocation_profiler {
+    platform_mutex lock;
+    uint64_t frame_count;
+
+    uint32_t record_capacity;
+    uint32_t record_count;
+    allocation_record* records;
+
+    uint32_t stack_capacity;
+    uint32_t stack_count;
+    allocation_stack* stacks;
+    // Allocations that found the stack table full and were not recorded.
+    uint64_t dropped_count;
+} allocation_profiler;
+
+// max_live_allocations is rounded up to a power of two.
+bool allocation_profiler_create(uint32_t max_live_allocations, allocation_profiler* out_profiler);
+void allocation_profiler_destroy(allocation_profiler* profiler);
+
+void allocation_profiler_on_allocate(allocation_profiler* profiler, void* block, uint64_t size, memory_tag tag, const char* file, uint32_t line);
+void allocation_profiler_on_free(allocation_profiler* profiler, void* block);
+void allocation_profiler_on_frame(allocation_profiler* profiler);
+
+// Logs every allocation still alive, grouped by allocation path.
+uint64_t allocation_profiler_report_leaks(allocation_profiler* profiler);
+
+// Writes one "outer;...;inner;file:line bytes" line per allocation path, the
+// collapsed stack format flame graph tools read. Weighted by total bytes allocated.
+bool allocation_profiler_write_collapsed_stacks(allocation_profiler* profiler, const char* path);
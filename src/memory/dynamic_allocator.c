@@ -0,0 +1,452 @@
+#include "dynamic_allocator.h"
+
+#include "../core/logger.h"
+
+#include <stddef.h>
+
+// Owned blocks at least this large are backed by huge pages.
+#define DYNAMIC_ALLOCATOR_HUGE_PAGE_THRESHOLD (2 * 1024 * 1024)
+
+// Blocks are 16 byte aligned, and every first level range is split into 32
+// second level lists. First level 0 covers every size below 512 bytes in
+// 16 byte steps, the others cover [2^n, 2^(n+1)).
+#define TLSF_ALIGN_LOG2 4
+#define TLSF_ALIGN (1ull << TLSF_ALIGN_LOG2)
+#define TLSF_SL_LOG2 5
+#define TLSF_SL_COUNT (1 << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_FL_MAX 40
+#define TLSF_FL_COUNT (TLSF_FL_MAX - TLSF_FL_SHIFT + 1)
+#define TLSF_SMALL_BLOCK_SIZE (1ull << TLSF_FL_SHIFT)
+
+#define BLOCK_FREE 0x1ull
+#define BLOCK_PREV_FREE 0x2ull
+#define BLOCK_FLAG_MASK (TLSF_ALIGN - 1)
+
+typedef struct tlsf_block {
+    // Physically previous block, used to coalesce on free.
+    struct tlsf_block* prev_physical;
+    // Payload size, with the BLOCK_* flags in the low bits.
+    uint64_t size;
+    // Free list links. They overlap the payload, so they only exist while the block is free.
+    struct tlsf_block* next_free;
+    struct tlsf_block* prev_free;
+} tlsf_block;
+
+#define BLOCK_HEADER_SIZE offsetof(tlsf_block, next_free)
+#define BLOCK_MIN_SIZE (sizeof(tlsf_block) - BLOCK_HEADER_SIZE)
+#define BLOCK_MAX_SIZE (1ull << (TLSF_FL_MAX - 1))
+
+typedef struct dynamic_allocator_control {
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[TLSF_FL_COUNT];
+    tlsf_block* blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];
+
+    uint8_t* pool_start;
+    uint8_t* pool_end;
+    uint64_t allocated;
+    uint64_t allocation_count;
+} dynamic_allocator_control;
+
+static inline uint32_t tlsf_fls(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return (uint32_t)index;
+#else
+    return 63 - (uint32_t)__builtin_clzll(value);
+#endif
+}
+
+static inline uint32_t tlsf_ffs(uint32_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctz(value);
+#endif
+}
+
+static inline uint64_t align_up(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static inline uint64_t block_size(const tlsf_block* block) {
+    return block->size & ~BLOCK_FLAG_MASK;
+}
+
+static inline void block_set_size(tlsf_block* block, uint64_t size) {
+    block->size = size | (block->size & BLOCK_FLAG_MASK);
+}
+
+static inline uint8_t* block_payload(const tlsf_block* block) {
+    return (uint8_t*)block + BLOCK_HEADER_SIZE;
+}
+
+static inline tlsf_block* block_from_payload(const void* payload) {
+    return (tlsf_block*)((uint8_t*)payload - BLOCK_HEADER_SIZE);
+}
+
+static inline tlsf_block* block_next(const tlsf_block* block) {
+    return (tlsf_block*)(block_payload(block) + block_size(block));
+}
+
+static inline tlsf_block* block_link_next(tlsf_block* block) {
+    tlsf_block* next = block_next(block);
+    next->prev_physical = block;
+    return next;
+}
+
+static void block_mark_free(tlsf_block* block) {
+    block->size |= BLOCK_FREE;
+    tlsf_block* next = block_link_next(block);
+    next->size |= BLOCK_PREV_FREE;
+}
+
+static void block_mark_used(tlsf_block* block) {
+    block->size &= ~BLOCK_FREE;
+    block_next(block)->size &= ~BLOCK_PREV_FREE;
+}
+
+static void mapping_insert(uint64_t size, uint32_t* out_fl, uint32_t* out_sl) {
+    if (size < TLSF_SMALL_BLOCK_SIZE) {
+        *out_fl = 0;
+        *out_sl = (uint32_t)(size / (TLSF_SMALL_BLOCK_SIZE / TLSF_SL_COUNT));
+    } else {
+        uint32_t fl = tlsf_fls(size);
+        *out_sl = (uint32_t)(size >> (fl - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *out_fl = fl - (TLSF_FL_SHIFT - 1);
+    }
+}
+
+// Rounds the request up to the next list so any block found there fits.
+static void mapping_search(uint64_t size, uint32_t* out_fl, uint32_t* out_sl) {
+    if (size >= TLSF_SMALL_BLOCK_SIZE) {
+        size += (1ull << (tlsf_fls(size) - TLSF_SL_LOG2)) - 1;
+    }
+    mapping_insert(size, out_fl, out_sl);
+}
+
+static tlsf_block* search_suitable_block(dynamic_allocator_control* control, uint32_t* fl, uint32_t* sl) {
+    if (*fl >= TLSF_FL_COUNT) {
+        return 0;
+    }
+
+    uint32_t sl_map = control->sl_bitmap[*fl] & (~0u << *sl);
+    if (!sl_map) {
+        uint32_t fl_map = *fl + 1 < 32 ? control->fl_bitmap & (~0u << (*fl + 1)) : 0;
+        if (!fl_map) {
+            return 0;
+        }
+        *fl = tlsf_ffs(fl_map);
+        sl_map = control->sl_bitmap[*fl];
+    }
+
+    *sl = tlsf_ffs(sl_map);
+    return control->blocks[*fl][*sl];
+}
+
+static void remove_free_block(dynamic_allocator_control* control, tlsf_block* block, uint32_t fl, uint32_t sl) {
+    tlsf_block* prev = block->prev_free;
+    tlsf_block* next = block->next_free;
+    if (next) {
+        next->prev_free = prev;
+    }
+    if (prev) {
+        prev->next_free = next;
+    }
+
+    if (control->blocks[fl][sl] == block) {
+        control->blocks[fl][sl] = next;
+        if (!next) {
+            control->sl_bitmap[fl] &= ~(1u << sl);
+            if (!control->sl_bitmap[fl]) {
+                control->fl_bitmap &= ~(1u << fl);
+            }
+        }
+    }
+}
+
+static void insert_free_block(dynamic_allocator_control* control, tlsf_block* block, uint32_t fl, uint32_t sl) {
+    tlsf_block* current = control->blocks[fl][sl];
+    block->next_free = current;
+    block->prev_free = 0;
+    if (current) {
+        current->prev_free = block;
+    }
+    control->blocks[fl][sl] = block;
+    control->fl_bitmap |= 1u << fl;
+    control->sl_bitmap[fl] |= 1u << sl;
+}
+
+static void block_remove(dynamic_allocator_control* control, tlsf_block* block) {
+    uint32_t fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    remove_free_block(control, block, fl, sl);
+}
+
+static void block_insert(dynamic_allocator_control* control, tlsf_block* block) {
+    uint32_t fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    insert_free_block(control, block, fl, sl);
+}
+
+// Splits the tail off a block, leaving it with size bytes of payload.
+static tlsf_block* block_split(tlsf_block* block, uint64_t size) {
+    tlsf_block* remaining = (tlsf_block*)(block_payload(block) + size);
+    remaining->size = block_size(block) - size - BLOCK_HEADER_SIZE;
+    block_set_size(block, size);
+    remaining->prev_physical = block;
+    return remaining;
+}
+
+static tlsf_block* block_absorb(tlsf_block* prev, tlsf_block* block) {
+    prev->size += block_size(block) + BLOCK_HEADER_SIZE;
+    block_link_next(prev);
+    return prev;
+}
+
+// Gives the unused tail of a free block back to the free lists.
+static void block_trim_free(dynamic_allocator_control* control, tlsf_block* block, uint64_t size) {
+    if (block_size(block) >= size + BLOCK_HEADER_SIZE + BLOCK_MIN_SIZE) {
+        tlsf_block* remaining = block_split(block, size);
+        remaining->size |= BLOCK_FREE;
+        block_link_next(remaining);
+        block_insert(control, remaining);
+    }
+}
+
+static void* block_prepare_used(dynamic_allocator_control* control, tlsf_block* block, uint64_t size) {
+    block_trim_free(control, block, size);
+    block_mark_used(block);
+    control->allocated += block_size(block);
+    control->allocation_count++;
+    return block_payload(block);
+}
+
+static uint64_t adjust_request_size(uint64_t size) {
+    uint64_t adjusted = align_up(size, TLSF_ALIGN);
+    return adjusted < BLOCK_MIN_SIZE ? BLOCK_MIN_SIZE : adjusted;
+}
+
+uint64_t dynamic_allocator_memory_requirement(uint64_t usable_size) {
+    return sizeof(dynamic_allocator_control) + TLSF_ALIGN + align_up(usable_size, TLSF_ALIGN) + 2 * BLOCK_HEADER_SIZE;
+}
+
+bool dynamic_allocator_create(uint64_t total_size, void* memory, dynamic_allocator* out_allocator) {
+    if (!out_allocator) {
+        return false;
+    }
+
+    if (total_size < dynamic_allocator_memory_requirement(BLOCK_MIN_SIZE)) {
+        KERROR("dynamic_allocator_create - total_size of %lluB is too small.", total_size);
+        return false;
+    }
+
+    out_allocator->total_size = total_size;
+    out_allocator->owns_memory = memory == 0;
+    out_allocator->memory_flags = MEMORY_FLAG_NONE;
+    if (memory) {
+        out_allocator->memory = memory;
+    } else {
+        if (total_size >= DYNAMIC_ALLOCATOR_HUGE_PAGE_THRESHOLD) {
+            out_allocator->memory_flags = MEMORY_FLAG_HUGE_PAGES;
+        }
+        out_allocator->memory = gallocate_flags(total_size, MEMORY_TAG_DYNAMIC_ALLOCATOR, out_allocator->memory_flags | MEMORY_FLAG_NO_ZERO);
+        if (!out_allocator->memory) {
+            return false;
+        }
+    }
+
+    dynamic_allocator_control* control = out_allocator->memory;
+    gzero_memory(control, sizeof(dynamic_allocator_control));
+    out_allocator->control = control;
+
+    // One free block spanning the pool, followed by a zero sized used block so
+    // the last real block always has a valid physical neighbour.
+    uint8_t* memory_end = (uint8_t*)out_allocator->memory + total_size;
+    control->pool_start = (uint8_t*)align_up((uint64_t)(control + 1), TLSF_ALIGN);
+    control->pool_end = (uint8_t*)((uint64_t)memory_end & ~(TLSF_ALIGN - 1));
+
+    uint64_t pool_size = (uint64_t)(control->pool_end - control->pool_start) - 2 * BLOCK_HEADER_SIZE;
+    if (pool_size >= BLOCK_MAX_SIZE) {
+        pool_size = BLOCK_MAX_SIZE - TLSF_ALIGN;
+        control->pool_end = control->pool_start + pool_size + 2 * BLOCK_HEADER_SIZE;
+    }
+
+    tlsf_block* block = (tlsf_block*)control->pool_start;
+    block->prev_physical = 0;
+    block->size = pool_size;
+    tlsf_block* sentinel = block_next(block);
+    sentinel->size = 0;
+    block_mark_free(block);
+    block_insert(control, block);
+
+    return true;
+}
+
+void dynamic_allocator_destroy(dynamic_allocator* allocator) {
+    if (allocator) {
+        if (allocator->owns_memory && allocator->memory) {
+            gfree_flags(allocator->memory, allocator->total_size, MEMORY_TAG_DYNAMIC_ALLOCATOR, allocator->memory_flags);
+        }
+        allocator->memory = 0;
+        allocator->control = 0;
+        allocator->total_size = 0;
+        allocator->owns_memory = false;
+        allocator->memory_flags = MEMORY_FLAG_NONE;
+    }
+}
+
+void* dynamic_allocator_allocate(dynamic_allocator* allocator, uint64_t size) {
+    if (!allocator || !allocator->control) {
+        KERROR("dynamic_allocator_allocate - provided allocator not initialized.");
+        return 0;
+    }
+
+    uint64_t adjusted = adjust_request_size(size);
+    if (adjusted >= BLOCK_MAX_SIZE) {
+        return 0;
+    }
+
+    dynamic_allocator_control* control = allocator->control;
+    uint32_t fl, sl;
+    mapping_search(adjusted, &fl, &sl);
+    tlsf_block* block = search_suitable_block(control, &fl, &sl);
+    if (!block) {
+        return 0;
+    }
+
+    remove_free_block(control, block, fl, sl);
+    return block_prepare_used(control, block, adjusted);
+}
+
+void* dynamic_allocator_allocate_aligned(dynamic_allocator* allocator, uint64_t size, uint64_t alignment) {
+    if (alignment <= TLSF_ALIGN) {
+        return dynamic_allocator_allocate(allocator, size);
+    }
+
+    if (!allocator || !allocator->control) {
+        KERROR("dynamic_allocator_allocate_aligned - provided allocator not initialized.");
+        return 0;
+    }
+
+    // Leave room to move the payload up to the alignment boundary. Any gap in
+    // front of it must be big enough to stand alone as a free block.
+    const uint64_t gap_minimum = BLOCK_HEADER_SIZE + BLOCK_MIN_SIZE;
+    uint64_t adjusted = adjust_request_size(size);
+    uint64_t size_with_gap = adjusted + alignment + gap_minimum;
+    if (size_with_gap >= BLOCK_MAX_SIZE) {
+        return 0;
+    }
+
+    dynamic_allocator_control* control = allocator->control;
+    uint32_t fl, sl;
+    mapping_search(size_with_gap, &fl, &sl);
+    tlsf_block* block = search_suitable_block(control, &fl, &sl);
+    if (!block) {
+        return 0;
+    }
+    remove_free_block(control, block, fl, sl);
+
+    uint64_t payload = (uint64_t)block_payload(block);
+    uint64_t aligned = align_up(payload, alignment);
+    uint64_t gap = aligned - payload;
+    if (gap && gap < gap_minimum) {
+        aligned = align_up(payload + gap_minimum, alignment);
+        gap = aligned - payload;
+    }
+
+    if (gap) {
+        tlsf_block* remaining = block_split(block, gap - BLOCK_HEADER_SIZE);
+        remaining->size |= BLOCK_FREE | BLOCK_PREV_FREE;
+        block_link_next(remaining);
+        block_insert(control, block);
+        block = remaining;
+    }
+
+    return block_prepare_used(control, block, adjusted);
+}
+
+bool dynamic_allocator_free(dynamic_allocator* allocator, void* block) {
+    if (!allocator || !allocator->control || !block) {
+        return false;
+    }
+
+    if (!dynamic_allocator_owns(allocator, block)) {
+        KERROR("dynamic_allocator_free - block %p does not belong to this allocator.", block);
+        return false;
+    }
+
+    dynamic_allocator_control* control = allocator->control;
+    tlsf_block* header = block_from_payload(block);
+    if (header->size & BLOCK_FREE) {
+        KERROR("dynamic_allocator_free - block %p was already freed.", block);
+        return false;
+    }
+
+    control->allocated -= block_size(header);
+    control->allocation_count--;
+
+    block_mark_free(header);
+    if (header->size & BLOCK_PREV_FREE) {
+        tlsf_block* prev = header->prev_physical;
+        block_remove(control, prev);
+        header = block_absorb(prev, header);
+    }
+
+    tlsf_block* next = block_next(header);
+    if (next->size & BLOCK_FREE) {
+        block_remove(control, next);
+        header = block_absorb(header, next);
+    }
+
+    block_insert(control, header);
+    return true;
+}
+
+bool dynamic_allocator_owns(dynamic_allocator* allocator, const void* block) {
+    if (!allocator || !allocator->control) {
+        return false;
+    }
+    const uint8_t* address = block;
+    return address >= allocator->control->pool_start && address < allocator->control->pool_end;
+}
+
+uint64_t dynamic_allocator_block_size(const void* block) {
+    return block ? block_size(block_from_payload(block)) : 0;
+}
+
+void dynamic_allocator_get_stats(dynamic_allocator* allocator, dynamic_allocator_stats* out_stats) {
+    gzero_memory(out_stats, sizeof(dynamic_allocator_stats));
+    if (!allocator || !allocator->control) {
+        return;
+    }
+
+    dynamic_allocator_control* control = allocator->control;
+    out_stats->total_size = allocator->total_size;
+    out_stats->usable_size = (uint64_t)(control->pool_end - control->pool_start) - 2 * BLOCK_HEADER_SIZE;
+    out_stats->allocated = control->allocated;
+    out_stats->allocation_count = control->allocation_count;
+
+    for (uint32_t fl = 0; fl < TLSF_FL_COUNT; ++fl) {
+        if (!(control->fl_bitmap & (1u << fl))) {
+            continue;
+        }
+        for (uint32_t sl = 0; sl < TLSF_SL_COUNT; ++sl) {
+            for (tlsf_block* block = control->blocks[fl][sl]; block; block = block->next_free) {
+                uint64_t size = block_size(block);
+                out_stats->free_size += size;
+                out_stats->free_block_count++;
+                if (size > out_stats->largest_free_block) {
+                    out_stats->largest_free_block = size;
+                }
+            }
+        }
+    }
+
+    if (out_stats->free_size) {
+        out_stats->fragmentation = 1.0f - (float)out_stats->largest_free_block / (float)out_stats->free_size;
+    }
+}
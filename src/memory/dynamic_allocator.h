@@ -0,0 +1,48 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../core/gmemory.h"
+
+// Two-level segregated fit (TLSF) allocator over a single pre-reserved block.
+// Allocation and free are O(1), neighbouring free blocks are coalesced on free,
+// and every block is at least 16 byte aligned. Not thread safe.
+typedef struct dynamic_allocator {
+    uint64_t total_size;
+    void* memory;
+    bool owns_memory;
+    memory_flags memory_flags;
+    // TLSF control structure, placed at the start of memory.
+    struct dynamic_allocator_control* control;
+} dynamic_allocator;
+
+typedef struct dynamic_allocator_stats {
+    uint64_t total_size;
+    // Bytes available to callers once the control structure is taken out.
+    uint64_t usable_size;
+    uint64_t allocated;
+    uint64_t allocation_count;
+    uint64_t free_size;
+    uint64_t free_block_count;
+    uint64_t largest_free_block;
+    // 0 when all free space is one block, approaching 1 as it splinters.
+    float fragmentation;
+} dynamic_allocator_stats;
+
+// Memory requirement for a block that should leave usable_size bytes for allocations.
+uint64_t dynamic_allocator_memory_requirement(uint64_t usable_size);
+
+// Passing 0 for memory makes the allocator own a block of total_size bytes.
+bool dynamic_allocator_create(uint64_t total_size, void* memory, dynamic_allocator* out_allocator);
+void dynamic_allocator_destroy(dynamic_allocator* allocator);
+
+void* dynamic_allocator_allocate(dynamic_allocator* allocator, uint64_t size);
+// alignment must be a power of two.
+void* dynamic_allocator_allocate_aligned(dynamic_allocator* allocator, uint64_t size, uint64_t alignment);
+bool dynamic_allocator_free(dynamic_allocator* allocator, void* block);
+
+bool dynamic_allocator_owns(dynamic_allocator* allocator, const void* block);
+// Usable size of an allocated block, which may be larger than requested.
+uint64_t dynamic_allocator_block_size(const void* block);
+
+void dynamic_allocator_get_stats(dynamic_allocator* allocator, dynamic_allocator_stats* out_stats);
@@ -0,0 +1,53 @@
+#include "frame_allocator.h"
+
+#include "../core/logger.h"
+
+bool frame_allocator_create(uint64_t arena_size, uint32_t frame_count, frame_allocator* out_allocator) {
+    if (!out_allocator || frame_count < 2 || frame_count > FRAME_ALLOCATOR_MAX_FRAMES) {
+        KERROR("frame_allocator_create - frame count must be between 2 and %u.", FRAME_ALLOCATOR_MAX_FRAMES);
+        return false;
+    }
+
+    gzero_memory(out_allocator, sizeof(frame_allocator));
+    out_allocator->frame_count = frame_count;
+    for (uint32_t i = 0; i < frame_count; ++i) {
+        linear_allocator_create(arena_size, 0, &out_allocator->arenas[i]);
+        if (!out_allocator->arenas[i].memory) {
+            KERROR("frame_allocator_create - failed to allocate a %lluB frame arena.", arena_size);
+            frame_allocator_destroy(out_allocator);
+            return false;
+        }
+    }
+    return true;
+}
+
+void frame_allocator_destroy(frame_allocator* allocator) {
+    if (allocator) {
+        for (uint32_t i = 0; i < allocator->frame_count; ++i) {
+            linear_allocator_destroy(&allocator->arenas[i]);
+        }
+        allocator->frame_count = 0;
+    }
+}
+
+void frame_allocator_begin_frame(frame_allocator* allocator) {
+    linear_allocator* previous = &allocator->arenas[allocator->current_frame];
+    allocator->last_frame_used = previous->high_water;
+    if (previous->high_water > allocator->high_water) {
+        allocator->high_water = previous->high_water;
+        allocator->high_water_frame = allocator->frame_number;
+    }
+
+    allocator->frame_number++;
+    allocator->current_frame = (uint32_t)(allocator->frame_number % allocator->frame_count);
+    // Transient data is always written before it is read, so skip the zero fill.
+    linear_allocator_free_all(&allocator->arenas[allocator->current_frame], false);
+}
+
+void* frame_allocator_allocate(frame_allocator* allocator, uint64_t size) {
+    void* block = linear_allocator_allocate(&allocator->arenas[allocator->current_frame], size);
+    if (!block) {
+        KERROR("frame_allocator_allocate - frame %llu is out of transient memory.", allocator->frame_number);
+    }
+    return block;
+}
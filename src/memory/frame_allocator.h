@@ -0,0 +1,32 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "linear_allocator.h"
+
+#define FRAME_ALLOCATOR_MAX_FRAMES 4
+
+// Ring of linear arenas, one per frame. An arena is only reset when its slot
+// comes around again, so with frame_count at least the renderer's frames in
+// flight plus one, the GPU has fenced the frame before its memory is reused.
+// Meant for the main thread.
+typedef struct frame_allocator {
+    uint32_t frame_count;
+    uint32_t current_frame;
+    uint64_t frame_number;
+    linear_allocator arenas[FRAME_ALLOCATOR_MAX_FRAMES];
+    // Most bytes any frame has used, and the frame that used them.
+    uint64_t high_water;
+    uint64_t high_water_frame;
+    // Bytes the previous frame ended up using.
+    uint64_t last_frame_used;
+} frame_allocator;
+
+bool frame_allocator_create(uint64_t arena_size, uint32_t frame_count, frame_allocator* out_allocator);
+void frame_allocator_destroy(frame_allocator* allocator);
+
+// Moves to the next arena and resets it. Called once at the top of each frame.
+void frame_allocator_begin_frame(frame_allocator* allocator);
+
+// Valid until the same slot comes around again, frame_count frames later.
+void* frame_allocator_allocate(frame_allocator* allocator, uint64_t size);
@@ -3,41 +3,60 @@
 #include "../core/gmemory.h"
 #include "../core/logger.h"
 
+// Owned blocks at least this large are backed by huge pages.
+#define LINEAR_ALLOCATOR_HUGE_PAGE_THRESHOLD (2 * 1024 * 1024)
+
 void linear_allocator_create(uint64_t total_size, void* memory, linear_allocator* out_allocator) {
     if (out_allocator) {
         out_allocator->total_size = total_size;
         out_allocator->allocated = 0;
+        out_allocator->high_water = 0;
         out_allocator->owns_memory = memory == 0;
+        out_allocator->memory_flags = MEMORY_FLAG_NONE;
         if (memory) {
             out_allocator->memory = memory;
         }
         else {
-            out_allocator->memory = gallocate(total_size, MEMORY_TAG_LINEAR_ALLOCATOR);
+            if (total_size >= LINEAR_ALLOCATOR_HUGE_PAGE_THRESHOLD) {
+                out_allocator->memory_flags = MEMORY_FLAG_HUGE_PAGES;
+            }
+            out_allocator->memory = gallocate_flags(total_size, MEMORY_TAG_LINEAR_ALLOCATOR, out_allocator->memory_flags);
         }
     }
 }
 void linear_allocator_destroy(linear_allocator* allocator) {
     if (allocator) {
         allocator->allocated = 0;
+        allocator->high_water = 0;
         if (allocator->owns_memory && allocator->memory) {
-            gfree(allocator->memory, allocator->total_size, MEMORY_TAG_LINEAR_ALLOCATOR);
+            gfree_flags(allocator->memory, allocator->total_size, MEMORY_TAG_LINEAR_ALLOCATOR, allocator->memory_flags);
         }
         allocator->memory = 0;
         allocator->total_size = 0;
         allocator->owns_memory = false;
+        allocator->memory_flags = MEMORY_FLAG_NONE;
     }
 }
 
 void* linear_allocator_allocate(linear_allocator* allocator, uint64_t size) {
+    return linear_allocator_allocate_aligned(allocator, size, 1);
+}
+
+void* linear_allocator_allocate_aligned(linear_allocator* allocator, uint64_t size, uint64_t alignment) {
     if (allocator && allocator->memory) {
-        if (allocator->allocated + size > allocator->total_size) {
+        uint64_t base = (uint64_t)allocator->memory;
+        uint64_t offset = ((base + allocator->allocated + alignment - 1) & ~(alignment - 1)) - base;
+        if (offset + size > allocator->total_size) {
             uint64_t remaining = allocator->total_size - allocator->allocated;
             KERROR("linear_allocator_allocate - Tried to allocate %lluB, only %lluB remaining.", size, remaining);
             return 0;
         }
 
-        void* block = ((uint8_t*)allocator->memory) + allocator->allocated;
-        allocator->allocated += size;
+        void* block = ((uint8_t*)allocator->memory) + offset;
+        allocator->allocated = offset + size;
+        if (allocator->allocated > allocator->high_water) {
+            allocator->high_water = allocator->allocated;
+        }
         return block;
     }
 
@@ -45,9 +64,42 @@ void* linear_allocator_allocate(linear_allocator* allocator, uint64_t size) {
     return 0;
 }
 
-void linear_allocator_free_all(linear_allocator* allocator) {
+void linear_allocator_free_all(linear_allocator* allocator, bool zero_memory) {
     if (allocator && allocator->memory) {
+        if (zero_memory) {
+            gzero_memory(allocator->memory, allocator->high_water);
+        }
         allocator->allocated = 0;
-        gzero_memory(allocator->memory, allocator->total_size);
+        allocator->high_water = 0;
     }
-}
\ No newline at end of file
+}
+
+linear_allocator_marker linear_allocator_get_marker(linear_allocator* allocator) {
+    return allocator->allocated;
+}
+
+void linear_allocator_rollback(linear_allocator* allocator, linear_allocator_marker marker) {
+    if (marker > allocator->allocated) {
+        KERROR("linear_allocator_rollback - marker %llu is past the current offset %llu.", marker, allocator->allocated);
+        return;
+    }
+    allocator->allocated = marker;
+}
+
+bool linear_allocator_try_extend(linear_allocator* allocator, void* block, uint64_t old_size, uint64_t new_size) {
+    if (!allocator || !allocator->memory || new_size < old_size) {
+        return false;
+    }
+    // The newest block ends where the free space starts.
+    uint64_t grow = new_size - old_size;
+    if ((uint8_t*)block + old_size != (uint8_t*)allocator->memory + allocator->allocated ||
+        allocator->allocated + grow > allocator->total_size) {
+        return false;
+    }
+
+    allocator->allocated += grow;
+    if (allocator->allocated > allocator->high_water) {
+        allocator->high_water = allocator->allocated;
+    }
+    return true;
+}
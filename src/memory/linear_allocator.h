@@ -2,15 +2,37 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "../core/gmemory.h"
+
 typedef struct linear_allocator {
     uint64_t total_size;
     uint64_t allocated;
+    // Furthest allocated has reached since the last free_all, which is all
+    // that needs zeroing.
+    uint64_t high_water;
     void* memory;
     bool owns_memory;
+    // Flags the owned block was allocated with.
+    memory_flags memory_flags;
 } linear_allocator;
 
+// Offset to roll back to. Everything allocated after it is released at once.
+typedef uint64_t linear_allocator_marker;
+
 void linear_allocator_create(uint64_t total_size, void* memory, linear_allocator* out_allocator);
 void linear_allocator_destroy(linear_allocator* allocator);
 
 void* linear_allocator_allocate(linear_allocator* allocator, uint64_t size);
-void linear_allocator_free_all(linear_allocator* allocator);
\ No newline at end of file
+// alignment must be a power of two.
+void* linear_allocator_allocate_aligned(linear_allocator* allocator, uint64_t size, uint64_t alignment);
+
+// Zeroing only covers the range used since the last free_all.
+void linear_allocator_free_all(linear_allocator* allocator, bool zero_memory);
+
+linear_allocator_marker linear_allocator_get_marker(linear_allocator* allocator);
+// Rolled back memory is not zeroed.
+void linear_allocator_rollback(linear_allocator* allocator, linear_allocator_marker marker);
+
+// Grows block from old_size to new_size in place. Only the newest block can
+// grow, and only while the arena has room; otherwise nothing changes.
+bool linear_allocator_try_extend(linear_allocator* allocator, void* block, uint64_t old_size, uint64_t new_size);
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "pool_allocator.h"
+
+#include "../core/logger.h"
+
+#define POOL_BLOCK_ALIGNMENT 16
+// Room for the slab chain pointer, keeping the first block cache line aligned.
+#define POOL_SLAB_HEADER_SIZE 64
+
+typedef struct pool_thread_cache {
+    // Generation of the cache slot the blocks were taken under.
+    int32_t generation;
+    uint32_t counts[POOL_ALLOCATOR_MAX_CLASSES];
+    void* blocks[POOL_ALLOCATOR_MAX_CLASSES][POOL_ALLOCATOR_THREAD_CACHE_SIZE];
+} pool_thread_cache;
+
+// A cache slot belongs to one live pool at a time. Its generation moves on
+// whenever the slot is taken or released, so blocks a thread cached for a
+// destroyed pool are dropped instead of handed to the next owner.
+static pool_allocator* volatile cache_slot_owners[POOL_ALLOCATOR_MAX_CACHED_POOLS];
+static volatile int32_t cache_slot_generations[POOL_ALLOCATOR_MAX_CACHED_POOLS];
+
+static _Thread_local pool_thread_cache thread_caches[POOL_ALLOCATOR_MAX_CACHED_POOLS];
+
+static int32_t pool_class_index(pool_allocator* allocator, uint64_t size) {
+    for (uint32_t i = 0; i < allocator->class_count; ++i) {
+        if (size <= allocator->classes[i].block_size) {
+            return (int32_t)i;
+        }
+    }
+    return -1;
+}
+
+// Expects the class lock to be held.
+static bool pool_class_grow(pool_allocator* allocator, pool_size_class* size_class) {
+    uint8_t* slab = gallocate_flags(allocator->slab_size, allocator->tag, MEMORY_FLAG_NO_ZERO | MEMORY_FLAG_ALIGN_64);
+    if (!slab) {
+        return false;
+    }
+
+    *(void**)slab = size_class->slabs;
+    size_class->slabs = slab;
+    size_class->slab_count++;
+
+    // Thread the list back to front so blocks are handed out in address order.
+    uint8_t* blocks = slab + POOL_SLAB_HEADER_SIZE;
+    for (uint32_t i = size_class->blocks_per_slab; i > 0; --i) {
+        void* block = blocks + (uint64_t)(i - 1) * size_class->block_size;
+        *(void**)block = size_class->free_list;
+        size_class->free_list = block;
+    }
+    return true;
+}
+
+// Pops up to count blocks off the shared free list. Returns how many were taken.
+static uint32_t pool_class_take(pool_allocator* allocator, pool_size_class* size_class, void** out_blocks, uint32_t count) {
+    platform_mutex_lock(&size_class->lock);
+    uint32_t taken = 0;
+    while (taken < count) {
+        if (!size_class->free_list && !pool_class_grow(allocator, size_class)) {
+            break;
+        }
+        out_blocks[taken++] = size_class->free_list;
+        size_class->free_list = *(void**)size_class->free_list;
+    }
+
+    size_class->in_use += taken;
+    if (size_class->in_use > size_class->peak_in_use) {
+        size_class->peak_in_use = size_class->in_use;
+    }
+    platform_mutex_unlock(&size_class->lock);
+    return taken;
+}
+
+static void pool_class_give(pool_size_class* size_class, void** blocks, uint32_t count) {
+    platform_mutex_lock(&size_class->lock);
+    for (uint32_t i = 0; i < count; ++i) {
+        *(void**)blocks[i] = size_class->free_list;
+        size_class->free_list = blocks[i];
+    }
+    size_class->in_use -= count;
+    platform_mutex_unlock(&size_class->lock);
+}
+
+static pool_thread_cache* pool_thread_cache_get(pool_allocator* allocator) {
+    if (allocator->cache_slot < 0) {
+        return 0;
+    }
+
+    pool_thread_cache* cache = &thread_caches[allocator->cache_slot];
+    int32_t generation = platform_atomic_load_i32(&cache_slot_generations[allocator->cache_slot]);
+    if (cache->generation != generation) {
+        // Whatever is left belonged to a pool that has since been destroyed.
+        for (uint32_t i = 0; i < POOL_ALLOCATOR_MAX_CLASSES; ++i) {
+            cache->counts[i] = 0;
+        }
+        cache->generation = generation;
+    }
+    return cache;
+}
+
+bool pool_allocator_create(pool_allocator_config* config, pool_allocator* out_allocator) {
+    if (!config || !out_allocator || config->class_count == 0 || config->class_count > POOL_ALLOCATOR_MAX_CLASSES) {
+        KERROR("pool_allocator_create - requires between 1 and %u size classes.", POOL_ALLOCATOR_MAX_CLASSES);
+        return false;
+    }
+
+    gzero_memory(out_allocator, sizeof(pool_allocator));
+    out_allocator->name = config->name ? config->name : "unnamed";
+    out_allocator->tag = config->tag;
+    out_allocator->slab_size = config->slab_size;
+    out_allocator->class_count = config->class_count;
+    out_allocator->cache_slot = -1;
+
+    for (uint32_t i = 0; i < config->class_count; ++i) {
+        pool_size_class* size_class = &out_allocator->classes[i];
+        uint32_t block_size = config->class_sizes[i] < sizeof(void*) ? sizeof(void*) : config->class_sizes[i];
+        size_class->block_size = (block_size + POOL_BLOCK_ALIGNMENT - 1) & ~(POOL_BLOCK_ALIGNMENT - 1);
+        if (i > 0 && size_class->block_size <= out_allocator->classes[i - 1].block_size) {
+            KERROR("pool_allocator_create - size classes of pool '%s' must be ascending.", out_allocator->name);
+            return false;
+        }
+
+        if (config->slab_size < POOL_SLAB_HEADER_SIZE + size_class->block_size) {
+            KERROR("pool_allocator_create - slab size %llu of pool '%s' cannot hold a %uB block.",
+                config->slab_size, out_allocator->name, size_class->block_size);
+            return false;
+        }
+        size_class->blocks_per_slab = (uint32_t)((config->slab_size - POOL_SLAB_HEADER_SIZE) / size_class->block_size);
+        platform_mutex_create(&size_class->lock);
+    }
+
+    if (config->thread_cache) {
+        for (int32_t i = 0; i < POOL_ALLOCATOR_MAX_CACHED_POOLS; ++i) {
+            void* expected = 0;
+            if (platform_atomic_compare_exchange_ptr((void* volatile*)&cache_slot_owners[i], &expected, out_allocator)) {
+                platform_atomic_add_i32(&cache_slot_generations[i], 1);
+                out_allocator->cache_slot = i;
+                break;
+            }
+        }
+        if (out_allocator->cache_slot < 0) {
+            KWARN("pool_allocator_create - out of thread cache slots, pool '%s' will run without one.", out_allocator->name);
+        }
+    }
+
+    memory_system_register_pool(out_allocator);
+    return true;
+}
+
+void pool_allocator_destroy(pool_allocator* allocator) {
+    if (!allocator) {
+        return;
+    }
+
+    memory_system_unregister_pool(allocator);
+
+    if (allocator->cache_slot >= 0) {
+        platform_atomic_add_i32(&cache_slot_generations[allocator->cache_slot], 1);
+        platform_atomic_store_ptr((void* volatile*)&cache_slot_owners[allocator->cache_slot], 0);
+    }
+
+    for (uint32_t i = 0; i < allocator->class_count; ++i) {
+        pool_size_class* size_class = &allocator->classes[i];
+        if (size_class->in_use) {
+            KWARN("pool_allocator_destroy - pool '%s' still has %llu blocks of %uB in use.",
+                allocator->name, size_class->in_use, size_class->block_size);
+        }
+
+        void* slab = size_class->slabs;
+        while (slab) {
+            void* next = *(void**)slab;
+            gfree_flags(slab, allocator->slab_size, allocator->tag, MEMORY_FLAG_NO_ZERO | MEMORY_FLAG_ALIGN_64);
+            slab = next;
+        }
+        platform_mutex_destroy(&size_class->lock);
+    }
+
+    gzero_memory(allocator, sizeof(pool_allocator));
+}
+
+void* pool_allocator_allocate(pool_allocator* allocator, uint64_t size) {
+    int32_t class_index = pool_class_index(allocator, size);
+    if (class_index < 0) {
+        KERROR("pool_allocator_allocate - pool '%s' has no size class for %llu bytes.", allocator->name, size);
+        return 0;
+    }
+
+    pool_size_class* size_class = &allocator->classes[class_index];
+    pool_thread_cache* cache = pool_thread_cache_get(allocator);
+    if (!cache) {
+        void* block = 0;
+        if (!pool_class_take(allocator, size_class, &block, 1)) {
+            KERROR("pool_allocator_allocate - pool '%s' failed to grow.", allocator->name);
+        }
+        return block;
+    }
+
+    uint32_t* count = &cache->counts[class_index];
+    if (*count == 0) {
+        // Refill half the cache so a following free does not spill straight back.
+        *count = pool_class_take(allocator, size_class, cache->blocks[class_index], POOL_ALLOCATOR_THREAD_CACHE_SIZE / 2);
+        if (*count == 0) {
+            KERROR("pool_allocator_allocate - pool '%s' failed to grow.", allocator->name);
+            return 0;
+        }
+    }
+    return cache->blocks[class_index][--(*count)];
+}
+
+void pool_allocator_free(pool_allocator* allocator, void* block, uint64_t size) {
+    if (!block) {
+        return;
+    }
+
+    int32_t class_index = pool_class_index(allocator, size);
+    if (class_index < 0) {
+        KERROR("pool_allocator_free - pool '%s' has no size class for %llu bytes.", allocator->name, size);
+        return;
+    }
+
+    pool_size_class* size_class = &allocator->classes[class_index];
+    pool_thread_cache* cache = pool_thread_cache_get(allocator);
+    if (!cache) {
+        pool_class_give(size_class, &block, 1);
+        return;
+    }
+
+    uint32_t* count = &cache->counts[class_index];
+    if (*count == POOL_ALLOCATOR_THREAD_CACHE_SIZE) {
+        // Hand the older half back so other threads can use it.
+        uint32_t spill = POOL_ALLOCATOR_THREAD_CACHE_SIZE / 2;
+        pool_class_give(size_class, cache->blocks[class_index], spill);
+        for (uint32_t i = spill; i < POOL_ALLOCATOR_THREAD_CACHE_SIZE; ++i) {
+            cache->blocks[class_index][i - spill] = cache->blocks[class_index][i];
+        }
+        *count -= spill;
+    }
+    cache->blocks[class_index][(*count)++] = block;
+}
+
+void pool_allocator_flush_thread_cache(pool_allocator* allocator) {
+    pool_thread_cache* cache = pool_thread_cache_get(allocator);
+    if (!cache) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < allocator->class_count; ++i) {
+        if (cache->counts[i]) {
+            pool_class_give(&allocator->classes[i], cache->blocks[i], cache->counts[i]);
+            cache->counts[i] = 0;
+        }
+    }
+}
+
+void pool_allocator_get_stats(pool_allocator* allocator, pool_allocator_stats* out_stats) {
+    gzero_memory(out_stats, sizeof(pool_allocator_stats));
+    out_stats->class_count = allocator->class_count;
+    for (uint32_t i = 0; i < allocator->class_count; ++i) {
+        pool_size_class* size_class = &allocator->classes[i];
+        pool_class_stats* stats = &out_stats->classes[i];
+
+        platform_mutex_lock(&size_class->lock);
+        stats->block_size = size_class->block_size;
+        stats->slab_count = size_class->slab_count;
+        stats->capacity = size_class->slab_count * size_class->blocks_per_slab;
+        stats->in_use = size_class->in_use;
+        stats->peak_in_use = size_class->peak_in_use;
+        platform_mutex_unlock(&size_class->lock);
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../core/gmemory.h"
+#include "../platform/platform.h"
+
+#define POOL_ALLOCATOR_MAX_CLASSES 8
+// Pools that can have thread caches enabled at the same time.
+#define POOL_ALLOCATOR_MAX_CACHED_POOLS 8
+#define POOL_ALLOCATOR_THREAD_CACHE_SIZE 16
+
+typedef struct pool_allocator_config {
+    const char* name;
+    // Tag the slabs are allocated under.
+    memory_tag tag;
+    // Block sizes in ascending order. Rounded up to multiples of 16.
+    uint32_t class_count;
+    uint32_t class_sizes[POOL_ALLOCATOR_MAX_CLASSES];
+    // Bytes per slab. Slabs are only returned when the pool is destroyed.
+    uint64_t slab_size;
+    // Keep a small per-thread stash of blocks for each class so most
+    // allocations and frees never touch the class lock.
+    bool thread_cache;
+} pool_allocator_config;
+
+typedef struct pool_size_class {
+    uint32_t block_size;
+    uint32_t blocks_per_slab;
+    platform_mutex lock;
+    // Intrusive list threaded through the free blocks.
+    void* free_list;
+    // Slabs are chained through their first bytes.
+    void* slabs;
+    uint64_t slab_count;
+    uint64_t in_use;
+    uint64_t peak_in_use;
+} pool_size_class;
+
+typedef struct pool_allocator {
+    const char* name;
+    memory_tag tag;
+    uint64_t slab_size;
+    // Thread cache slot, or -1 without thread caches.
+    int32_t cache_slot;
+    uint32_t class_count;
+    pool_size_class classes[POOL_ALLOCATOR_MAX_CLASSES];
+} pool_allocator;
+
+typedef struct pool_class_stats {
+    uint32_t block_size;
+    uint64_t slab_count;
+    uint64_t capacity;
+    // Blocks held by callers or parked in thread caches.
+    uint64_t in_use;
+    uint64_t peak_in_use;
+} pool_class_stats;
+
+typedef struct pool_allocator_stats {
+    uint32_t class_count;
+    pool_class_stats classes[POOL_ALLOCATOR_MAX_CLASSES];
+} pool_allocator_stats;
+
+// Registers the pool with the memory system so it shows up in get_memory_usage_str.
+bool pool_allocator_create(pool_allocator_config* config, pool_allocator* out_allocator);
+void pool_allocator_destroy(pool_allocator* allocator);
+
+// Returns a block from the smallest class that fits size, or 0 if none does.
+void* pool_allocator_allocate(pool_allocator* allocator, uint64_t size);
+// size must fall in the same class the block was allocated from.
+void pool_allocator_free(pool_allocator* allocator, void* block, uint64_t size);
+
+// Hands the calling thread's cached blocks back to the pool. Threads that
+// used a cached pool should call this before they exit.
+void pool_allocator_flush_thread_cache(pool_allocator* allocator);
+
+void pool_allocator_get_stats(pool_allocator* allocator, pool_allocator_stats* out_stats);
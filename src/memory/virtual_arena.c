@@ -0,0 +1,98 @@
+#include "virtual_arena.h"
+
+#include "../core/logger.h"
+#include "../platform/platform.h"
+
+#define VIRTUAL_ARENA_DEFAULT_COMMIT_STEP (64 * 1024)
+
+static uint64_t virtual_arena_round(uint64_t size, uint64_t granularity) {
+    return ((size + granularity - 1) / granularity) * granularity;
+}
+
+bool virtual_arena_create(uint64_t reserved_size, uint64_t commit_step, virtual_arena* out_arena) {
+    if (!out_arena) {
+        return false;
+    }
+
+    uint64_t page_size = platform_get_page_size();
+    gzero_memory(out_arena, sizeof(virtual_arena));
+    out_arena->reserved_size = virtual_arena_round(reserved_size, page_size);
+    out_arena->commit_step = virtual_arena_round(commit_step ? commit_step : VIRTUAL_ARENA_DEFAULT_COMMIT_STEP, page_size);
+    out_arena->memory = platform_reserve_memory(out_arena->reserved_size);
+    if (!out_arena->memory) {
+        KERROR("virtual_arena_create - failed to reserve %lluB of address space.", out_arena->reserved_size);
+        return false;
+    }
+    return true;
+}
+
+void virtual_arena_destroy(virtual_arena* arena) {
+    if (arena && arena->memory) {
+        memory_system_track_external(arena->committed_size, MEMORY_TAG_VIRTUAL_ARENA, false);
+        platform_release_memory(arena->memory, arena->reserved_size);
+        gzero_memory(arena, sizeof(virtual_arena));
+    }
+}
+
+void* virtual_arena_allocate(virtual_arena* arena, uint64_t size) {
+    return virtual_arena_allocate_aligned(arena, size, 1);
+}
+
+void* virtual_arena_allocate_aligned(virtual_arena* arena, uint64_t size, uint64_t alignment) {
+    if (!arena || !arena->memory) {
+        KERROR("virtual_arena_allocate - provided arena not initialized.");
+        return 0;
+    }
+
+    uint64_t base = (uint64_t)arena->memory;
+    uint64_t offset = ((base + arena->allocated + alignment - 1) & ~(alignment - 1)) - base;
+    uint64_t end = offset + size;
+    if (end > arena->reserved_size) {
+        KERROR("virtual_arena_allocate - Tried to allocate %lluB, only %lluB of the reservation remaining.",
+            size, arena->reserved_size - arena->allocated);
+        return 0;
+    }
+
+    if (end > arena->committed_size) {
+        uint64_t new_committed = virtual_arena_round(end, arena->commit_step);
+        if (new_committed > arena->reserved_size) {
+            new_committed = arena->reserved_size;
+        }
+
+        uint64_t grow = new_committed - arena->committed_size;
+        if (!platform_commit_memory((uint8_t*)arena->memory + arena->committed_size, grow)) {
+            KERROR("virtual_arena_allocate - failed to commit %lluB.", grow);
+            return 0;
+        }
+        memory_system_track_external(grow, MEMORY_TAG_VIRTUAL_ARENA, true);
+        arena->committed_size = new_committed;
+    }
+
+    arena->allocated = end;
+    return (uint8_t*)arena->memory + offset;
+}
+
+void virtual_arena_reset(virtual_arena* arena, bool decommit) {
+    if (!arena || !arena->memory) {
+        return;
+    }
+
+    arena->allocated = 0;
+    if (decommit && arena->committed_size) {
+        platform_decommit_memory(arena->memory, arena->committed_size);
+        memory_system_track_external(arena->committed_size, MEMORY_TAG_VIRTUAL_ARENA, false);
+        arena->committed_size = 0;
+    }
+}
+
+virtual_arena_marker virtual_arena_get_marker(virtual_arena* arena) {
+    return arena->allocated;
+}
+
+void virtual_arena_rollback(virtual_arena* arena, virtual_arena_marker marker) {
+    if (marker > arena->allocated) {
+        KERROR("virtual_arena_rollback - marker %llu is past the current offset %llu.", marker, arena->allocated);
+        return;
+    }
+    arena->allocated = marker;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../core/gmemory.h"
+
+// Bump allocator over a reserved range of address space. Pages are committed
+// as the arena grows, so it never moves and pointers into it stay valid, and
+// only the touched part counts towards resident memory.
+typedef struct virtual_arena {
+    uint64_t reserved_size;
+    uint64_t committed_size;
+    uint64_t allocated;
+    // Pages are committed in steps of this many bytes.
+    uint64_t commit_step;
+    void* memory;
+} virtual_arena;
+
+typedef uint64_t virtual_arena_marker;
+
+// commit_step is rounded up to whole pages. 0 uses a 64 KiB step.
+bool virtual_arena_create(uint64_t reserved_size, uint64_t commit_step, virtual_arena* out_arena);
+void virtual_arena_destroy(virtual_arena* arena);
+
+// New memory is zeroed. Memory reused after a rollback or a reset without
+// decommit is not.
+void* virtual_arena_allocate(virtual_arena* arena, uint64_t size);
+// alignment must be a power of two.
+void* virtual_arena_allocate_aligned(virtual_arena* arena, uint64_t size, uint64_t alignment);
+
+// With decommit, every committed page is handed back to the OS.
+void virtual_arena_reset(virtual_arena* arena, bool decommit);
+
+virtual_arena_marker virtual_arena_get_marker(virtual_arena* arena);
+void virtual_arena_rollback(virtual_arena* arena, virtual_arena_marker marker);
@@ -1,28 +1,181 @@
-#include <stdbool.h>
-#include <stdint.h>
-
-bool platform_system_startup(
-	uint64_t* memory_requirement,
-	void* state,
-	const char* application_name,
-	int32_t x,
-	int32_t y,
-	int32_t width,
-	int32_t height);
-
-void platform_system_shutdown(void* state);
-
-bool platform_pump_messages();
-
-void* platform_allocate(uint64_t size, uint8_t align);
-void platform_free(void* block, uint8_t align);
-void* platform_zero_memory(void* block, uint64_t size);
-void* platform_copy_memory(void* dest, const void* source, uint64_t size);
-void* platform_set_memory(void* dest, int32_t value, uint64_t size);
-
-void platform_console_write(const char* message, uint8_t colour);
-void platform_console_write_error(const char* message, uint8_t colour);
-
-double platform_get_absolute_time();
-
-void platform_sleep(uint64_t ms);
\ No newline at end of file
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+bool platform_system_startup(
+	uint64_t* memory_requirement,
+	void* state,
+	const char* application_name,
+	int32_t x,
+	int32_t y,
+	int32_t width,
+	int32_t height);
+
+void platform_system_shutdown(void* state);
+
+bool platform_pump_messages();
+
+// align is in bytes (a power of two); 0 uses the default malloc alignment.
+// Blocks must be freed with the same align they were allocated with.
+void* platform_allocate(uint64_t size, uint8_t align);
+void platform_free(void* block, uint8_t align);
+// Resizes a platform_allocate block, in place when the heap can extend it.
+// The old block stays valid when this fails. old_size is needed for aligned
+// blocks, which the C heap cannot resize and are moved by hand.
+void* platform_reallocate(void* block, uint64_t old_size, uint64_t new_size, uint8_t align);
+
+#define PLATFORM_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// Maps whole pages straight from the OS; they come back zero-filled. With
+// huge_pages the range is rounded up to PLATFORM_HUGE_PAGE_SIZE and backed by
+// huge pages when the system allows it, falling back to regular pages.
+void* platform_allocate_pages(uint64_t size, bool huge_pages);
+void platform_free_pages(void* block, uint64_t size, bool huge_pages);
+
+uint64_t platform_get_page_size();
+
+// Address space only. Nothing is backed until it is committed. Offsets and
+// sizes passed to commit and decommit must be page aligned.
+void* platform_reserve_memory(uint64_t size);
+// Committed pages read as zero the first time they are touched.
+bool platform_commit_memory(void* block, uint64_t size);
+// Hands the pages back to the OS but keeps the range reserved.
+void platform_decommit_memory(void* block, uint64_t size);
+void platform_release_memory(void* block, uint64_t size);
+// Return addresses of the calling thread's stack, innermost first, leaving out
+// this function and skip_frames callers above it. Returns the number written.
+uint32_t platform_capture_backtrace(void** out_frames, uint32_t max_frames, uint32_t skip_frames);
+// Writes "symbol+0xoffset" for a code address, or "module+0xoffset" when the
+// symbol is not exported.
+void platform_describe_address(void* address, char* out_buffer, uint32_t buffer_size);
+// Writes just the name of the function containing a code address, so every
+// call site in one function describes the same. Falls back to the address
+// form when the function cannot be named.
+void platform_describe_function(void* address, char* out_buffer, uint32_t buffer_size);
+
+// Blocks at or past the streaming thresholds are written with non-temporal
+// stores that bypass the cache, with AVX2 when the CPU has it.
+void* platform_zero_memory(void* block, uint64_t size);
+void* platform_copy_memory(void* dest, const void* source, uint64_t size);
+void* platform_set_memory(void* dest, int32_t value, uint64_t size);
+void platform_memory_set_streaming_thresholds(uint64_t copy_size, uint64_t set_size);
+// "avx2", "sse2" or "libc".
+const char* platform_memory_path_name();
+// True when the CPU and OS both support AVX2. Checked once and cached.
+bool platform_cpu_supports_avx2();
+
+void platform_console_write(const char* message, uint8_t colour);
+void platform_console_write_error(const char* message, uint8_t colour);
+
+double platform_get_absolute_time();
+
+void platform_sleep(uint64_t ms);
+
+// Threading
+
+typedef uint32_t (*pfn_thread_start)(void* params);
+
+typedef struct platform_thread {
+	void* internal_data;
+	uint64_t thread_id;
+} platform_thread;
+
+typedef struct platform_mutex {
+	void* internal_data;
+} platform_mutex;
+
+typedef struct platform_semaphore {
+	void* internal_data;
+} platform_semaphore;
+
+typedef struct platform_condition {
+	void* internal_data;
+} platform_condition;
+
+#define PLATFORM_MAX_LOGICAL_PROCESSORS 256
+#define PLATFORM_MAX_CORE_THREADS 8
+
+typedef struct platform_cpu_core {
+	uint32_t package_id;
+	// Index of the L2/L3 group this core belongs to; cores with the same
+	// index share that cache.
+	uint32_t l2_group;
+	uint32_t l3_group;
+	// SMT siblings of this core, as OS logical processor numbers.
+	uint32_t logical_count;
+	uint32_t logical_processors[PLATFORM_MAX_CORE_THREADS];
+} platform_cpu_core;
+
+typedef struct platform_cpu_topology {
+	uint32_t logical_processor_count;
+	uint32_t physical_core_count;
+	uint32_t package_count;
+	uint32_t l2_group_count;
+	uint32_t l3_group_count;
+	// Physical cores in ascending order of their first logical processor.
+	platform_cpu_core cores[PLATFORM_MAX_LOGICAL_PROCESSORS];
+} platform_cpu_topology;
+
+uint32_t platform_get_processor_count();
+// Falls back to one core per logical processor when the OS does not expose
+// the topology.
+bool platform_get_cpu_topology(platform_cpu_topology* out_topology);
+
+bool platform_thread_create(pfn_thread_start start_function, void* params, platform_thread* out_thread);
+// Blocks until the thread exits, then releases it.
+void platform_thread_join(platform_thread* thread);
+uint64_t platform_current_thread_id();
+void platform_thread_yield();
+
+// Restricts a thread to the given OS logical processors.
+bool platform_thread_set_affinity(platform_thread* thread, const uint32_t* logical_processors, uint32_t count);
+bool platform_current_thread_set_affinity(const uint32_t* logical_processors, uint32_t count);
+
+bool platform_mutex_create(platform_mutex* out_mutex);
+void platform_mutex_destroy(platform_mutex* mutex);
+bool platform_mutex_lock(platform_mutex* mutex);
+bool platform_mutex_unlock(platform_mutex* mutex);
+
+bool platform_semaphore_create(uint32_t initial_count, platform_semaphore* out_semaphore);
+void platform_semaphore_destroy(platform_semaphore* semaphore);
+bool platform_semaphore_signal(platform_semaphore* semaphore, uint32_t count);
+bool platform_semaphore_wait(platform_semaphore* semaphore);
+
+bool platform_condition_create(platform_condition* out_condition);
+void platform_condition_destroy(platform_condition* condition);
+// The mutex must be held; it is released while waiting and re-acquired before returning.
+bool platform_condition_wait(platform_condition* condition, platform_mutex* mutex);
+bool platform_condition_signal(platform_condition* condition);
+bool platform_condition_broadcast(platform_condition* condition);
+
+// Atomics are sequentially consistent unless noted. add returns the value after
+// the addition, exchange returns the previous value, and compare_exchange stores
+// the current value into expected when it fails.
+int32_t platform_atomic_add_i32(volatile int32_t* value, int32_t amount);
+int32_t platform_atomic_load_i32(volatile int32_t* value);
+void platform_atomic_store_i32(volatile int32_t* value, int32_t new_value);
+int32_t platform_atomic_exchange_i32(volatile int32_t* value, int32_t new_value);
+bool platform_atomic_compare_exchange_i32(volatile int32_t* value, int32_t* expected, int32_t desired);
+
+int64_t platform_atomic_add_i64(volatile int64_t* value, int64_t amount);
+int64_t platform_atomic_load_i64(volatile int64_t* value);
+void platform_atomic_store_i64(volatile int64_t* value, int64_t new_value);
+int64_t platform_atomic_exchange_i64(volatile int64_t* value, int64_t new_value);
+bool platform_atomic_compare_exchange_i64(volatile int64_t* value, int64_t* expected, int64_t desired);
+// Relaxed: no ordering, only untorn values. For counters with a single writer.
+int64_t platform_atomic_load_relaxed_i64(volatile int64_t* value);
+void platform_atomic_store_relaxed_i64(volatile int64_t* value, int64_t new_value);
+// Acquire/release pair for publishing data to another thread without a full
+// fence: writes before the release store are visible after the acquire load.
+int64_t platform_atomic_load_acquire_i64(volatile int64_t* value);
+void platform_atomic_store_release_i64(volatile int64_t* value, int64_t new_value);
+
+void* platform_atomic_load_ptr(void* volatile* value);
+void platform_atomic_store_ptr(void* volatile* value, void* new_value);
+void* platform_atomic_exchange_ptr(void* volatile* value, void* new_value);
+bool platform_atomic_compare_exchange_ptr(void* volatile* value, void** expected, void* desired);
+
+void platform_atomic_thread_fence();
+// Hint for spin-wait loops.
+void platform_cpu_pause();
@@ -0,0 +1,234 @@
+#include "platform.h"
+
+#include <string.h>
+
+// Bulk memory routines shared by every platform. Blocks that are cached, or
+// will be, stay with libc, which is already vectorized. Only blocks too large
+// to stay in cache are written with non-temporal stores, using AVX2 when the
+// CPU has it.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PLATFORM_MEMORY_X64 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PLATFORM_MEMORY_AVX2
+#else
+#include <cpuid.h>
+#define PLATFORM_MEMORY_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// Past these sizes writing through the cache only evicts data that is still
+// useful. Measured with bench/memory_benchmark.c; fills stay competitive in
+// cache for longer than copies, which also have to read the source.
+#define PLATFORM_MEMORY_DEFAULT_COPY_STREAMING_THRESHOLD (8 * 1024 * 1024)
+#define PLATFORM_MEMORY_DEFAULT_SET_STREAMING_THRESHOLD (32 * 1024 * 1024)
+// The streaming loops assume at least a few vectors' worth of data.
+#define PLATFORM_MEMORY_STREAMING_MIN_SIZE 256
+
+typedef enum platform_memory_path {
+    PLATFORM_MEMORY_PATH_UNKNOWN,
+    PLATFORM_MEMORY_PATH_LIBC,
+    PLATFORM_MEMORY_PATH_SSE2,
+    PLATFORM_MEMORY_PATH_AVX2
+} platform_memory_path;
+
+static platform_memory_path memory_path = PLATFORM_MEMORY_PATH_UNKNOWN;
+static uint64_t copy_streaming_threshold = PLATFORM_MEMORY_DEFAULT_COPY_STREAMING_THRESHOLD;
+static uint64_t set_streaming_threshold = PLATFORM_MEMORY_DEFAULT_SET_STREAMING_THRESHOLD;
+
+#if PLATFORM_MEMORY_X64
+static bool platform_cpu_has_avx2() {
+    uint32_t registers[4] = {0};
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    registers[2] = (uint32_t)info[2];
+#else
+    __cpuid(1, registers[0], registers[1], registers[2], registers[3]);
+#endif
+
+    // The OS has to save the YMM registers too, or AVX faults.
+    bool osxsave = registers[2] & (1u << 27);
+    bool avx = registers[2] & (1u << 28);
+    if (!osxsave || !avx) {
+        return false;
+    }
+#if defined(_MSC_VER)
+    uint64_t xcr0 = _xgetbv(0);
+#else
+    uint32_t xcr0_low, xcr0_high;
+    __asm__("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+    uint64_t xcr0 = ((uint64_t)xcr0_high << 32) | xcr0_low;
+#endif
+    if ((xcr0 & 0x6) != 0x6) {
+        return false;
+    }
+
+#if defined(_MSC_VER)
+    __cpuidex(info, 7, 0);
+    registers[1] = (uint32_t)info[1];
+#else
+    __cpuid_count(7, 0, registers[0], registers[1], registers[2], registers[3]);
+#endif
+    return registers[1] & (1u << 5);
+}
+
+PLATFORM_MEMORY_AVX2 static void platform_copy_stream_avx2(uint8_t* dest, const uint8_t* source, uint64_t size) {
+    // Copy the unaligned head, then run with aligned stores.
+    _mm256_storeu_si256((__m256i*)dest, _mm256_loadu_si256((const __m256i*)source));
+    uint64_t skip = 32 - ((uint64_t)dest & 31);
+    dest += skip;
+    source += skip;
+    size -= skip;
+
+    __m256i tail = _mm256_loadu_si256((const __m256i*)(source + size - 32));
+    uint8_t* tail_dest = dest + size - 32;
+    for (; size >= 128; size -= 128, source += 128, dest += 128) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)source);
+        __m256i b = _mm256_loadu_si256((const __m256i*)(source + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i*)(source + 64));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(source + 96));
+        _mm256_stream_si256((__m256i*)dest, a);
+        _mm256_stream_si256((__m256i*)(dest + 32), b);
+        _mm256_stream_si256((__m256i*)(dest + 64), c);
+        _mm256_stream_si256((__m256i*)(dest + 96), d);
+    }
+    _mm_sfence();
+    for (; size >= 32; size -= 32, source += 32, dest += 32) {
+        _mm256_store_si256((__m256i*)dest, _mm256_loadu_si256((const __m256i*)source));
+    }
+    _mm256_storeu_si256((__m256i*)tail_dest, tail);
+}
+
+PLATFORM_MEMORY_AVX2 static void platform_set_stream_avx2(uint8_t* dest, uint8_t value, uint64_t size) {
+    __m256i fill = _mm256_set1_epi8((char)value);
+    _mm256_storeu_si256((__m256i*)dest, fill);
+    _mm256_storeu_si256((__m256i*)(dest + size - 32), fill);
+
+    uint64_t skip = 32 - ((uint64_t)dest & 31);
+    dest += skip;
+    size -= skip;
+    for (; size >= 128; size -= 128, dest += 128) {
+        _mm256_stream_si256((__m256i*)dest, fill);
+        _mm256_stream_si256((__m256i*)(dest + 32), fill);
+        _mm256_stream_si256((__m256i*)(dest + 64), fill);
+        _mm256_stream_si256((__m256i*)(dest + 96), fill);
+    }
+    _mm_sfence();
+    for (; size >= 32; size -= 32, dest += 32) {
+        _mm256_store_si256((__m256i*)dest, fill);
+    }
+}
+
+// Every x64 CPU has SSE2, so streaming stores are always available.
+static void platform_copy_stream_sse2(uint8_t* dest, const uint8_t* source, uint64_t size) {
+    uint64_t skip = 16 - ((uint64_t)dest & 15);
+    _mm_storeu_si128((__m128i*)dest, _mm_loadu_si128((const __m128i*)source));
+    dest += skip;
+    source += skip;
+    size -= skip;
+
+    __m128i tail = _mm_loadu_si128((const __m128i*)(source + size - 16));
+    uint8_t* tail_dest = dest + size - 16;
+    for (; size >= 64; size -= 64, source += 64, dest += 64) {
+        __m128i a = _mm_loadu_si128((const __m128i*)source);
+        __m128i b = _mm_loadu_si128((const __m128i*)(source + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(source + 32));
+        __m128i d = _mm_loadu_si128((const __m128i*)(source + 48));
+        _mm_stream_si128((__m128i*)dest, a);
+        _mm_stream_si128((__m128i*)(dest + 16), b);
+        _mm_stream_si128((__m128i*)(dest + 32), c);
+        _mm_stream_si128((__m128i*)(dest + 48), d);
+    }
+    _mm_sfence();
+    for (; size >= 16; size -= 16, source += 16, dest += 16) {
+        _mm_store_si128((__m128i*)dest, _mm_loadu_si128((const __m128i*)source));
+    }
+    _mm_storeu_si128((__m128i*)tail_dest, tail);
+}
+
+static void platform_set_stream_sse2(uint8_t* dest, uint8_t value, uint64_t size) {
+    __m128i fill = _mm_set1_epi8((char)value);
+    _mm_storeu_si128((__m128i*)dest, fill);
+    _mm_storeu_si128((__m128i*)(dest + size - 16), fill);
+
+    uint64_t skip = 16 - ((uint64_t)dest & 15);
+    dest += skip;
+    size -= skip;
+    for (; size >= 64; size -= 64, dest += 64) {
+        _mm_stream_si128((__m128i*)dest, fill);
+        _mm_stream_si128((__m128i*)(dest + 16), fill);
+        _mm_stream_si128((__m128i*)(dest + 32), fill);
+        _mm_stream_si128((__m128i*)(dest + 48), fill);
+    }
+    _mm_sfence();
+    for (; size >= 16; size -= 16, dest += 16) {
+        _mm_store_si128((__m128i*)dest, fill);
+    }
+}
+#endif
+
+static platform_memory_path platform_memory_detect() {
+#if PLATFORM_MEMORY_X64
+    memory_path = platform_cpu_has_avx2() ? PLATFORM_MEMORY_PATH_AVX2 : PLATFORM_MEMORY_PATH_SSE2;
+#else
+    memory_path = PLATFORM_MEMORY_PATH_LIBC;
+#endif
+    return memory_path;
+}
+
+void platform_memory_set_streaming_thresholds(uint64_t copy_size, uint64_t set_size) {
+    copy_streaming_threshold = copy_size > PLATFORM_MEMORY_STREAMING_MIN_SIZE ? copy_size : PLATFORM_MEMORY_STREAMING_MIN_SIZE;
+    set_streaming_threshold = set_size > PLATFORM_MEMORY_STREAMING_MIN_SIZE ? set_size : PLATFORM_MEMORY_STREAMING_MIN_SIZE;
+}
+
+const char* platform_memory_path_name() {
+    switch (memory_path ? memory_path : platform_memory_detect()) {
+        case PLATFORM_MEMORY_PATH_AVX2:
+            return "avx2";
+        case PLATFORM_MEMORY_PATH_SSE2:
+            return "sse2";
+        default:
+            return "libc";
+    }
+}
+
+bool platform_cpu_supports_avx2() {
+    return (memory_path ? memory_path : platform_memory_detect()) == PLATFORM_MEMORY_PATH_AVX2;
+}
+
+void* platform_zero_memory(void* block, uint64_t size) {
+    return platform_set_memory(block, 0, size);
+}
+
+void* platform_copy_memory(void* dest, const void* source, uint64_t size) {
+#if PLATFORM_MEMORY_X64
+    if (size >= copy_streaming_threshold) {
+        platform_memory_path path = memory_path ? memory_path : platform_memory_detect();
+        if (path == PLATFORM_MEMORY_PATH_AVX2) {
+            platform_copy_stream_avx2(dest, source, size);
+        } else {
+            platform_copy_stream_sse2(dest, source, size);
+        }
+        return dest;
+    }
+#endif
+    return memcpy(dest, source, size);
+}
+
+void* platform_set_memory(void* dest, int32_t value, uint64_t size) {
+#if PLATFORM_MEMORY_X64
+    if (size >= set_streaming_threshold) {
+        platform_memory_path path = memory_path ? memory_path : platform_memory_detect();
+        if (path == PLATFORM_MEMORY_PATH_AVX2) {
+            platform_set_stream_avx2(dest, (uint8_t)value, size);
+        } else {
+            platform_set_stream_sse2(dest, (uint8_t)value, size);
+        }
+        return dest;
+    }
+#endif
+    return memset(dest, value, size);
+}
@@ -1,293 +1,728 @@
-#include "platform.h"
-#include "../core/logger.h"
-#include "../core/input.h"
-#include "../core/event.h"
-
-#include "../containers/darray.h"
-
-#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
-
-#include <windows.h>
-#include <windowsx.h>
-#include <WinUser.h>
-#include <stdbool.h>
-
-#include <vulkan/vulkan.h>
-#include <vulkan/vulkan_win32.h>
-#include "../renderer/vulkan/vulkan_types.inl"
-
-typedef struct platform_state {
-	HINSTANCE h_instance;
-	HWND hwnd;
-	VkSurfaceKHR surface;
-	double clock_frequency;
-	LARGE_INTEGER start_time;
-} platform_state;
-
-static platform_state* state_ptr;
-
-LRESULT CALLBACK win32_process_message(HWND hwnd, uint32_t msg, WPARAM w_param, LPARAM l_param);
-
-bool platform_system_startup(
-	uint64_t* memory_requirement,
-	void* state,
-	const char* application_name,
-	int32_t x,
-	int32_t y,
-	int32_t width,
-	int32_t height) {
-
-	*memory_requirement = sizeof(platform_state);
-	if (state == 0) {
-		return true;
-	}
-	state_ptr = state;
-
-	state_ptr->h_instance = GetModuleHandleA(0);
-
-	HICON icon = LoadIcon(state_ptr->h_instance, IDI_APPLICATION);
-	WNDCLASSA wc;
-	memset(&wc, 0, sizeof(wc));
-	wc.style = CS_DBLCLKS;
-	wc.lpfnWndProc = win32_process_message;
-	wc.cbClsExtra = 0;
-	wc.cbWndExtra = 0;
-	wc.hInstance = state_ptr->h_instance;
-	wc.hIcon = icon;
-	wc.hCursor = LoadCursor(NULL, IDC_ARROW);
-	wc.hbrBackground = NULL;
-	wc.lpszClassName = "windows_class";
-
-	if (!RegisterClassA(&wc)) {
-		MessageBoxA(0, "Windows registration failed", "Error", MB_ICONEXCLAMATION | MB_OK);
-		return false;
-	}
-
-	uint32_t client_x = x;
-	uint32_t client_y = y;
-	uint32_t client_width = width;
-	uint32_t client_height = height;
-
-	uint32_t window_x = client_x;
-	uint32_t window_y = client_y;
-	uint32_t window_width = client_width;
-	uint32_t window_height = client_height;
-
-	uint32_t window_style = WS_OVERLAPPED | WS_SYSMENU | WS_CAPTION;
-	uint32_t window_ex_style = WS_EX_APPWINDOW;
-
-	window_style |= WS_MAXIMIZEBOX;
-	window_style |= WS_MINIMIZEBOX;
-	window_style |= WS_THICKFRAME;
-
-	RECT border_rect = { 0, 0, 0, 0 };
-	AdjustWindowRectEx(&border_rect, window_style, 0, window_ex_style);
-
-	window_x += border_rect.left;
-	window_y += border_rect.top;
-
-	window_width += border_rect.right - border_rect.left;
-	window_height += border_rect.bottom - border_rect.top;
-
-	HWND handle = CreateWindowExA(
-		window_ex_style, "windows_class", application_name,
-		window_style, window_x, window_y, window_width, window_height,
-		0, 0, state_ptr->h_instance, 0);
-
-	if (handle == 0) {
-		MessageBoxA(NULL, "window creation failed: ", "Error:", MB_ICONEXCLAMATION | MB_OK);
-
-		KFATAL("Window creation failed!");
-		return false;
-	}
-	else {
-		state_ptr->hwnd = handle;
-	}
-
-	bool should_activate = true;
-	int32_t show_window_command_flags = should_activate ? SW_SHOW : SW_SHOWNOACTIVATE;
-
-	ShowWindow(state_ptr->hwnd, show_window_command_flags);
-
-	LARGE_INTEGER frequency;
-	QueryPerformanceFrequency(&frequency);
-	state_ptr->clock_frequency = 1.0 / (double)frequency.QuadPart;
-	QueryPerformanceCounter(&state_ptr->start_time);
-
-	return true;
-}
-
-void platform_system_shutdown(void* plat_state) {
-	if (state_ptr && state_ptr->hwnd) {
-		DestroyWindow(state_ptr->hwnd);
-		state_ptr->hwnd = 0;
-	}
-}
-
-bool platform_pump_messages() {
-	if (state_ptr) {
-		MSG message;
-		while (PeekMessageA(&message, NULL, 0, 0, PM_REMOVE)) {
-			TranslateMessage(&message);
-			DispatchMessageA(&message);
-		}
-	}
-	return true;
-}
-
-void* platform_allocate(uint64_t size, uint8_t aligned) {
-	return malloc(size);
-}
-
-void platform_free(void* block, uint8_t aligned) {
-	free(block);
-}
-
-void* platform_zero_memory(void* block, uint64_t size) {
-	return memset(block, 0, size);
-}
-
-void* platform_copy_memory(void* dest, const void* source, uint64_t size) {
-	return memcpy(dest, source, size);
-}
-
-void* platform_set_memory(void* dest, int32_t value, uint64_t size) {
-	return memset(dest, value, size);
-}
-
-void platform_console_write(const char* message, uint8_t colour) {
-	HANDLE console_handle = GetStdHandle(STD_OUTPUT_HANDLE);
-	static uint8_t levels[6] = { 64, 4, 6, 2, 1, 8 };
-	SetConsoleTextAttribute(console_handle, levels[colour]);
-
-	OutputDebugStringA(message);
-	uint64_t length = strlen(message);
-	LPDWORD number_writen = 0;
-	WriteConsoleA(GetStdHandle(STD_OUTPUT_HANDLE), message, (DWORD)length, number_writen, 0);
-}
-
-void platform_console_write_error(const char* message, uint8_t colour) {
-	HANDLE console_handle = GetStdHandle(STD_OUTPUT_HANDLE);
-	static uint8_t levels[6] = { 64, 4, 6, 2, 1, 8 };
-	SetConsoleTextAttribute(console_handle, levels[colour]);
-
-	OutputDebugStringA(message);
-	uint64_t length = strlen(message);
-	LPDWORD number_writen = 0;
-	WriteConsoleA(GetStdHandle(STD_ERROR_HANDLE), message, (DWORD)length, number_writen, 0);
-}
-
-double platform_get_absolute_time() {
-	if (state_ptr) {
-		LARGE_INTEGER now_time;
-		QueryPerformanceCounter(&now_time);
-		return (double)now_time.QuadPart * state_ptr->clock_frequency;
-	}
-	return 0;
-}
-
-void platform_sleep(uint64_t ms) {
-	Sleep(1000 * ms);
-}
-
-void platform_get_required_extension_names(const char*** names_darray) {
-	darray_push(*names_darray, &"VK_KHR_win32_surface");
-}
-
-bool platform_create_vulkan_surface(vulkan_context *context) {
-	if (!state_ptr) {
-		return false;
-	}
-
-	VkWin32SurfaceCreateInfoKHR create_info = {VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR };
-	create_info.hinstance = state_ptr->h_instance;
-	create_info.hwnd = state_ptr->hwnd;
-
-	VkResult result = vkCreateWin32SurfaceKHR(context->instance, &create_info, context->allocator, &state_ptr->surface);
-	if (result != VK_SUCCESS) {
-		KFATAL("Vulkan surface creation failed");
-		return false;
-	}
-
-	context->surface = state_ptr->surface;
-
-	return true;
-}
-
-LRESULT CALLBACK win32_process_message(HWND hwnd, uint32_t msg, WPARAM w_param, LPARAM l_param) {
-	switch (msg) {
-	case WM_ERASEBKGND:
-		return 1;
-	case WM_CLOSE:
-		event_context data;
-		event_fire(EVENT_CODE_APPLICATION_QUIT, 0, data);
-		return TRUE;
-	case WM_DESTROY:
-		PostQuitMessage(0);
-		return 0;
-	case WM_SIZE: {
-		RECT r;
-		GetClientRect(hwnd, &r);
-		uint32_t width = r.right - r.left;
-		uint32_t height = r.bottom - r.top;
-	
-		event_context context;
-		context.data.u16[0] = (uint16_t)width;
-		context.data.u16[1] = (uint16_t)height;
-		event_fire(EVENT_CODE_RESIZED, 0, context);
-	}break;
-	case WM_KEYDOWN:
-	case WM_SYSKEYDOWN:
-	case WM_KEYUP:
-	case WM_SYSKEYUP: {
-		int8_t pressed = (msg == WM_KEYDOWN || msg == WM_SYSKEYDOWN);
-		keys key = (uint16_t)w_param;
-	
-		input_process_key(key, pressed);
-	} break;
-	case WM_MOUSEMOVE: {
-		int32_t x_position = GET_X_LPARAM(l_param);
-		int32_t y_position = GET_Y_LPARAM(l_param);
-
-		input_process_mouse_move(x_position, y_position);
-	} break;
-	case WM_MOUSEWHEEL: {
-		int32_t z_delta = GET_WHEEL_DELTA_WPARAM(w_param);
-		if (z_delta != 0) {
-			z_delta = (z_delta < 0) ? -1 : 1;
-			input_process_mouse_wheel(z_delta);
-		}
-	} break;
-	case WM_LBUTTONDOWN:
-	case WM_MBUTTONDOWN:
-	case WM_RBUTTONDOWN:
-	case WM_LBUTTONUP:
-	case WM_MBUTTONUP:
-	case WM_RBUTTONUP: {
-		int8_t pressed = msg == WM_LBUTTONDOWN || msg == WM_RBUTTONDOWN || msg == WM_MBUTTONDOWN;
-		buttons mouse_button = BUTTON_MAX_BUTTONS;
-		switch (msg) {
-		case WM_LBUTTONDOWN:
-		case WM_LBUTTONUP:
-			mouse_button = BUTTON_LEFT;
-			break;
-		case WM_MBUTTONDOWN:
-		case WM_MBUTTONUP:
-			mouse_button = BUTTON_MIDDLE;
-			break;
-		case WM_RBUTTONDOWN:
-		case WM_RBUTTONUP:
-			mouse_button = BUTTON_RIGHT;
-			break;
-		}
-
-		if (mouse_button != BUTTON_MAX_BUTTONS) {
-			input_process_button(mouse_button, pressed);
-		}
-	}break; 
-	}//switch
-
-	return DefWindowProcA(hwnd, msg, w_param, l_param);
-}
-
+#include "platform.h"
+#include "../core/logger.h"
+#include "../core/input.h"
+#include "../core/event.h"
+
+#include "../containers/darray.h"
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+
+#include <windows.h>
+#include <windowsx.h>
+#include <WinUser.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_win32.h>
+#include "../renderer/vulkan/vulkan_types.inl"
+
+typedef struct platform_state {
+	HINSTANCE h_instance;
+	HWND hwnd;
+	VkSurfaceKHR surface;
+	double clock_frequency;
+	LARGE_INTEGER start_time;
+} platform_state;
+
+static platform_state* state_ptr;
+
+LRESULT CALLBACK win32_process_message(HWND hwnd, uint32_t msg, WPARAM w_param, LPARAM l_param);
+
+bool platform_system_startup(
+	uint64_t* memory_requirement,
+	void* state,
+	const char* application_name,
+	int32_t x,
+	int32_t y,
+	int32_t width,
+	int32_t height) {
+
+	*memory_requirement = sizeof(platform_state);
+	if (state == 0) {
+		return true;
+	}
+	state_ptr = state;
+
+	state_ptr->h_instance = GetModuleHandleA(0);
+
+	HICON icon = LoadIcon(state_ptr->h_instance, IDI_APPLICATION);
+	WNDCLASSA wc;
+	memset(&wc, 0, sizeof(wc));
+	wc.style = CS_DBLCLKS;
+	wc.lpfnWndProc = win32_process_message;
+	wc.cbClsExtra = 0;
+	wc.cbWndExtra = 0;
+	wc.hInstance = state_ptr->h_instance;
+	wc.hIcon = icon;
+	wc.hCursor = LoadCursor(NULL, IDC_ARROW);
+	wc.hbrBackground = NULL;
+	wc.lpszClassName = "windows_class";
+
+	if (!RegisterClassA(&wc)) {
+		MessageBoxA(0, "Windows registration failed", "Error", MB_ICONEXCLAMATION | MB_OK);
+		return false;
+	}
+
+	uint32_t client_x = x;
+	uint32_t client_y = y;
+	uint32_t client_width = width;
+	uint32_t client_height = height;
+
+	uint32_t window_x = client_x;
+	uint32_t window_y = client_y;
+	uint32_t window_width = client_width;
+	uint32_t window_height = client_height;
+
+	uint32_t window_style = WS_OVERLAPPED | WS_SYSMENU | WS_CAPTION;
+	uint32_t window_ex_style = WS_EX_APPWINDOW;
+
+	window_style |= WS_MAXIMIZEBOX;
+	window_style |= WS_MINIMIZEBOX;
+	window_style |= WS_THICKFRAME;
+
+	RECT border_rect = { 0, 0, 0, 0 };
+	AdjustWindowRectEx(&border_rect, window_style, 0, window_ex_style);
+
+	window_x += border_rect.left;
+	window_y += border_rect.top;
+
+	window_width += border_rect.right - border_rect.left;
+	window_height += border_rect.bottom - border_rect.top;
+
+	HWND handle = CreateWindowExA(
+		window_ex_style, "windows_class", application_name,
+		window_style, window_x, window_y, window_width, window_height,
+		0, 0, state_ptr->h_instance, 0);
+
+	if (handle == 0) {
+		MessageBoxA(NULL, "window creation failed: ", "Error:", MB_ICONEXCLAMATION | MB_OK);
+
+		KFATAL("Window creation failed!");
+		return false;
+	}
+	else {
+		state_ptr->hwnd = handle;
+	}
+
+	bool should_activate = true;
+	int32_t show_window_command_flags = should_activate ? SW_SHOW : SW_SHOWNOACTIVATE;
+
+	ShowWindow(state_ptr->hwnd, show_window_command_flags);
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	state_ptr->clock_frequency = 1.0 / (double)frequency.QuadPart;
+	QueryPerformanceCounter(&state_ptr->start_time);
+
+	return true;
+}
+
+void platform_system_shutdown(void* plat_state) {
+	if (state_ptr && state_ptr->hwnd) {
+		DestroyWindow(state_ptr->hwnd);
+		state_ptr->hwnd = 0;
+	}
+}
+
+bool platform_pump_messages() {
+	if (state_ptr) {
+		MSG message;
+		while (PeekMessageA(&message, NULL, 0, 0, PM_REMOVE)) {
+			TranslateMessage(&message);
+			DispatchMessageA(&message);
+		}
+	}
+	return true;
+}
+
+void* platform_allocate(uint64_t size, uint8_t align) {
+	if (align) {
+		return _aligned_malloc(size, align);
+	}
+	return malloc(size);
+}
+
+void platform_free(void* block, uint8_t align) {
+	if (align) {
+		_aligned_free(block);
+	} else {
+		free(block);
+	}
+}
+
+void* platform_reallocate(void* block, uint64_t old_size, uint64_t new_size, uint8_t align) {
+	if (align) {
+		return _aligned_realloc(block, new_size, align);
+	}
+	return realloc(block, new_size);
+}
+
+void* platform_allocate_pages(uint64_t size, bool huge_pages) {
+	if (huge_pages) {
+		// Needs SeLockMemoryPrivilege; without it fall through to regular pages.
+		SIZE_T large_page_size = GetLargePageMinimum();
+		if (large_page_size) {
+			SIZE_T rounded_size = (size + large_page_size - 1) & ~(large_page_size - 1);
+			void* block = VirtualAlloc(0, rounded_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+			if (block) {
+				return block;
+			}
+		}
+	}
+	return VirtualAlloc(0, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+void platform_free_pages(void* block, uint64_t size, bool huge_pages) {
+	if (block) {
+		VirtualFree(block, 0, MEM_RELEASE);
+	}
+}
+
+uint64_t platform_get_page_size() {
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwPageSize;
+}
+
+void* platform_reserve_memory(uint64_t size) {
+	return VirtualAlloc(0, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+bool platform_commit_memory(void* block, uint64_t size) {
+	return VirtualAlloc(block, size, MEM_COMMIT, PAGE_READWRITE) != 0;
+}
+
+void platform_decommit_memory(void* block, uint64_t size) {
+	VirtualFree(block, size, MEM_DECOMMIT);
+}
+
+void platform_release_memory(void* block, uint64_t size) {
+	if (block) {
+		VirtualFree(block, 0, MEM_RELEASE);
+	}
+}
+
+uint32_t platform_capture_backtrace(void** out_frames, uint32_t max_frames, uint32_t skip_frames) {
+	return CaptureStackBackTrace(skip_frames + 1, max_frames, out_frames, 0);
+}
+
+void platform_describe_address(void* address, char* out_buffer, uint32_t buffer_size) {
+	// Symbol names would need DbgHelp; module and offset are enough to resolve offline.
+	HMODULE module = 0;
+	char module_path[MAX_PATH];
+	if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)address, &module) &&
+		GetModuleFileNameA(module, module_path, MAX_PATH)) {
+		const char* module_name = strrchr(module_path, '\\');
+		snprintf(out_buffer, buffer_size, "%s+0x%llx", module_name ? module_name + 1 : module_path, (unsigned long long)((uint8_t*)address - (uint8_t*)module));
+	} else {
+		snprintf(out_buffer, buffer_size, "%p", address);
+	}
+}
+
+void platform_describe_function(void* address, char* out_buffer, uint32_t buffer_size) {
+#if defined(_WIN64)
+	// The unwind tables know where each function starts, so module plus the
+	// function's offset names it without needing DbgHelp.
+	DWORD64 image_base = 0;
+	PRUNTIME_FUNCTION function = RtlLookupFunctionEntry((DWORD64)address, &image_base, 0);
+	char module_path[MAX_PATH];
+	if (function && GetModuleFileNameA((HMODULE)image_base, module_path, MAX_PATH)) {
+		const char* module_name = strrchr(module_path, '\\');
+		snprintf(out_buffer, buffer_size, "%s+0x%lx", module_name ? module_name + 1 : module_path, (unsigned long)function->BeginAddress);
+		return;
+	}
+#endif
+	platform_describe_address(address, out_buffer, buffer_size);
+}
+
+void platform_console_write(const char* message, uint8_t colour) {
+	HANDLE console_handle = GetStdHandle(STD_OUTPUT_HANDLE);
+	static uint8_t levels[6] = { 64, 4, 6, 2, 1, 8 };
+	SetConsoleTextAttribute(console_handle, levels[colour]);
+
+	OutputDebugStringA(message);
+	uint64_t length = strlen(message);
+	LPDWORD number_writen = 0;
+	WriteConsoleA(GetStdHandle(STD_OUTPUT_HANDLE), message, (DWORD)length, number_writen, 0);
+}
+
+void platform_console_write_error(const char* message, uint8_t colour) {
+	HANDLE console_handle = GetStdHandle(STD_OUTPUT_HANDLE);
+	static uint8_t levels[6] = { 64, 4, 6, 2, 1, 8 };
+	SetConsoleTextAttribute(console_handle, levels[colour]);
+
+	OutputDebugStringA(message);
+	uint64_t length = strlen(message);
+	LPDWORD number_writen = 0;
+	WriteConsoleA(GetStdHandle(STD_ERROR_HANDLE), message, (DWORD)length, number_writen, 0);
+}
+
+double platform_get_absolute_time() {
+	if (state_ptr) {
+		LARGE_INTEGER now_time;
+		QueryPerformanceCounter(&now_time);
+		return (double)now_time.QuadPart * state_ptr->clock_frequency;
+	}
+	return 0;
+}
+
+void platform_sleep(uint64_t ms) {
+	Sleep(1000 * ms);
+}
+
+uint32_t platform_get_processor_count() {
+	SYSTEM_INFO sys_info;
+	GetSystemInfo(&sys_info);
+	return sys_info.dwNumberOfProcessors;
+}
+
+static uint32_t win32_cache_group(KAFFINITY* masks, uint32_t* count, KAFFINITY core_mask) {
+	for (uint32_t i = 0; i < *count; ++i) {
+		if (masks[i] & core_mask) {
+			return i;
+		}
+	}
+	return 0;
+}
+
+// Only processor group 0 is considered, which covers up to 64 logical processors.
+bool platform_get_cpu_topology(platform_cpu_topology* out_topology) {
+	if (!out_topology) {
+		return false;
+	}
+	memset(out_topology, 0, sizeof(platform_cpu_topology));
+
+	DWORD length = 0;
+	GetLogicalProcessorInformationEx(RelationAll, 0, &length);
+	SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* buffer = malloc(length);
+	if (!buffer || !GetLogicalProcessorInformationEx(RelationAll, buffer, &length)) {
+		free(buffer);
+		uint32_t count = platform_get_processor_count();
+		for (uint32_t i = 0; i < count && i < PLATFORM_MAX_LOGICAL_PROCESSORS; ++i) {
+			out_topology->cores[i].logical_count = 1;
+			out_topology->cores[i].logical_processors[0] = i;
+		}
+		out_topology->logical_processor_count = count;
+		out_topology->physical_core_count = count;
+		out_topology->package_count = 1;
+		return count > 0;
+	}
+
+	KAFFINITY package_masks[PLATFORM_MAX_LOGICAL_PROCESSORS];
+	KAFFINITY l2_masks[PLATFORM_MAX_LOGICAL_PROCESSORS];
+	KAFFINITY l3_masks[PLATFORM_MAX_LOGICAL_PROCESSORS];
+	KAFFINITY core_masks[PLATFORM_MAX_LOGICAL_PROCESSORS];
+
+	uint8_t* cursor = (uint8_t*)buffer;
+	uint8_t* end = cursor + length;
+	while (cursor < end) {
+		SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)cursor;
+		if (info->Relationship == RelationProcessorCore && info->Processor.GroupMask[0].Group == 0) {
+			core_masks[out_topology->physical_core_count++] = info->Processor.GroupMask[0].Mask;
+		} else if (info->Relationship == RelationProcessorPackage) {
+			package_masks[out_topology->package_count++] = info->Processor.GroupMask[0].Mask;
+		} else if (info->Relationship == RelationCache && info->Cache.Type != CacheInstruction) {
+			if (info->Cache.Level == 2) {
+				l2_masks[out_topology->l2_group_count++] = info->Cache.GroupMask.Mask;
+			} else if (info->Cache.Level == 3) {
+				l3_masks[out_topology->l3_group_count++] = info->Cache.GroupMask.Mask;
+			}
+		}
+		cursor += info->Size;
+	}
+	free(buffer);
+
+	for (uint32_t i = 0; i < out_topology->physical_core_count; ++i) {
+		platform_cpu_core* core = &out_topology->cores[i];
+		core->package_id = win32_cache_group(package_masks, &out_topology->package_count, core_masks[i]);
+		core->l2_group = win32_cache_group(l2_masks, &out_topology->l2_group_count, core_masks[i]);
+		core->l3_group = win32_cache_group(l3_masks, &out_topology->l3_group_count, core_masks[i]);
+		for (uint32_t bit = 0; bit < 64; ++bit) {
+			if ((core_masks[i] & ((KAFFINITY)1 << bit)) && core->logical_count < PLATFORM_MAX_CORE_THREADS) {
+				core->logical_processors[core->logical_count++] = bit;
+				out_topology->logical_processor_count++;
+			}
+		}
+	}
+
+	return out_topology->physical_core_count > 0;
+}
+
+bool platform_thread_create(pfn_thread_start start_function, void* params, platform_thread* out_thread) {
+	if (!start_function || !out_thread) {
+		return false;
+	}
+
+	DWORD thread_id = 0;
+	out_thread->internal_data = CreateThread(0, 0, (LPTHREAD_START_ROUTINE)start_function, params, 0, &thread_id);
+	if (!out_thread->internal_data) {
+		KERROR("platform_thread_create - CreateThread failed.");
+		return false;
+	}
+	out_thread->thread_id = thread_id;
+	return true;
+}
+
+void platform_thread_join(platform_thread* thread) {
+	if (thread && thread->internal_data) {
+		WaitForSingleObject((HANDLE)thread->internal_data, INFINITE);
+		CloseHandle((HANDLE)thread->internal_data);
+		thread->internal_data = 0;
+		thread->thread_id = 0;
+	}
+}
+
+uint64_t platform_current_thread_id() {
+	return (uint64_t)GetCurrentThreadId();
+}
+
+void platform_thread_yield() {
+	SwitchToThread();
+}
+
+static bool win32_set_affinity(HANDLE thread, const uint32_t* logical_processors, uint32_t count) {
+	DWORD_PTR mask = 0;
+	for (uint32_t i = 0; i < count; ++i) {
+		if (logical_processors[i] < 64) {
+			mask |= (DWORD_PTR)1 << logical_processors[i];
+		}
+	}
+
+	if (!mask || !SetThreadAffinityMask(thread, mask)) {
+		KWARN("Failed to set thread affinity.");
+		return false;
+	}
+	return true;
+}
+
+bool platform_thread_set_affinity(platform_thread* thread, const uint32_t* logical_processors, uint32_t count) {
+	if (!thread || !thread->internal_data || !logical_processors || count == 0) {
+		return false;
+	}
+	return win32_set_affinity((HANDLE)thread->internal_data, logical_processors, count);
+}
+
+bool platform_current_thread_set_affinity(const uint32_t* logical_processors, uint32_t count) {
+	if (!logical_processors || count == 0) {
+		return false;
+	}
+	return win32_set_affinity(GetCurrentThread(), logical_processors, count);
+}
+
+bool platform_mutex_create(platform_mutex* out_mutex) {
+	if (!out_mutex) {
+		return false;
+	}
+
+	CRITICAL_SECTION* section = malloc(sizeof(CRITICAL_SECTION));
+	InitializeCriticalSection(section);
+	out_mutex->internal_data = section;
+	return true;
+}
+
+void platform_mutex_destroy(platform_mutex* mutex) {
+	if (mutex && mutex->internal_data) {
+		DeleteCriticalSection(mutex->internal_data);
+		free(mutex->internal_data);
+		mutex->internal_data = 0;
+	}
+}
+
+bool platform_mutex_lock(platform_mutex* mutex) {
+	if (!mutex || !mutex->internal_data) {
+		return false;
+	}
+	EnterCriticalSection(mutex->internal_data);
+	return true;
+}
+
+bool platform_mutex_unlock(platform_mutex* mutex) {
+	if (!mutex || !mutex->internal_data) {
+		return false;
+	}
+	LeaveCriticalSection(mutex->internal_data);
+	return true;
+}
+
+bool platform_semaphore_create(uint32_t initial_count, platform_semaphore* out_semaphore) {
+	if (!out_semaphore) {
+		return false;
+	}
+
+	out_semaphore->internal_data = CreateSemaphoreA(0, initial_count, LONG_MAX, 0);
+	if (!out_semaphore->internal_data) {
+		KERROR("platform_semaphore_create - CreateSemaphore failed.");
+		return false;
+	}
+	return true;
+}
+
+void platform_semaphore_destroy(platform_semaphore* semaphore) {
+	if (semaphore && semaphore->internal_data) {
+		CloseHandle((HANDLE)semaphore->internal_data);
+		semaphore->internal_data = 0;
+	}
+}
+
+bool platform_semaphore_signal(platform_semaphore* semaphore, uint32_t count) {
+	if (!semaphore || !semaphore->internal_data) {
+		return false;
+	}
+	return ReleaseSemaphore((HANDLE)semaphore->internal_data, (LONG)count, 0) != 0;
+}
+
+bool platform_semaphore_wait(platform_semaphore* semaphore) {
+	if (!semaphore || !semaphore->internal_data) {
+		return false;
+	}
+	return WaitForSingleObject((HANDLE)semaphore->internal_data, INFINITE) == WAIT_OBJECT_0;
+}
+
+bool platform_condition_create(platform_condition* out_condition) {
+	if (!out_condition) {
+		return false;
+	}
+
+	CONDITION_VARIABLE* condition = malloc(sizeof(CONDITION_VARIABLE));
+	InitializeConditionVariable(condition);
+	out_condition->internal_data = condition;
+	return true;
+}
+
+void platform_condition_destroy(platform_condition* condition) {
+	if (condition && condition->internal_data) {
+		free(condition->internal_data);
+		condition->internal_data = 0;
+	}
+}
+
+bool platform_condition_wait(platform_condition* condition, platform_mutex* mutex) {
+	if (!condition || !condition->internal_data || !mutex || !mutex->internal_data) {
+		return false;
+	}
+	return SleepConditionVariableCS(condition->internal_data, mutex->internal_data, INFINITE) != 0;
+}
+
+bool platform_condition_signal(platform_condition* condition) {
+	if (!condition || !condition->internal_data) {
+		return false;
+	}
+	WakeConditionVariable(condition->internal_data);
+	return true;
+}
+
+bool platform_condition_broadcast(platform_condition* condition) {
+	if (!condition || !condition->internal_data) {
+		return false;
+	}
+	WakeAllConditionVariable(condition->internal_data);
+	return true;
+}
+
+int32_t platform_atomic_add_i32(volatile int32_t* value, int32_t amount) {
+	return InterlockedAdd((volatile LONG*)value, amount);
+}
+
+int32_t platform_atomic_load_i32(volatile int32_t* value) {
+	return InterlockedCompareExchange((volatile LONG*)value, 0, 0);
+}
+
+void platform_atomic_store_i32(volatile int32_t* value, int32_t new_value) {
+	InterlockedExchange((volatile LONG*)value, new_value);
+}
+
+int32_t platform_atomic_exchange_i32(volatile int32_t* value, int32_t new_value) {
+	return InterlockedExchange((volatile LONG*)value, new_value);
+}
+
+bool platform_atomic_compare_exchange_i32(volatile int32_t* value, int32_t* expected, int32_t desired) {
+	int32_t previous = InterlockedCompareExchange((volatile LONG*)value, desired, *expected);
+	if (previous == *expected) {
+		return true;
+	}
+	*expected = previous;
+	return false;
+}
+
+int64_t platform_atomic_add_i64(volatile int64_t* value, int64_t amount) {
+	return InterlockedAdd64((volatile LONG64*)value, amount);
+}
+
+int64_t platform_atomic_load_i64(volatile int64_t* value) {
+	return InterlockedCompareExchange64((volatile LONG64*)value, 0, 0);
+}
+
+void platform_atomic_store_i64(volatile int64_t* value, int64_t new_value) {
+	InterlockedExchange64((volatile LONG64*)value, new_value);
+}
+
+int64_t platform_atomic_exchange_i64(volatile int64_t* value, int64_t new_value) {
+	return InterlockedExchange64((volatile LONG64*)value, new_value);
+}
+
+bool platform_atomic_compare_exchange_i64(volatile int64_t* value, int64_t* expected, int64_t desired) {
+	int64_t previous = InterlockedCompareExchange64((volatile LONG64*)value, desired, *expected);
+	if (previous == *expected) {
+		return true;
+	}
+	*expected = previous;
+	return false;
+}
+
+// Aligned 64-bit loads and stores are single instructions on x64, so a
+// volatile access is enough.
+int64_t platform_atomic_load_relaxed_i64(volatile int64_t* value) {
+	return *value;
+}
+
+void platform_atomic_store_relaxed_i64(volatile int64_t* value, int64_t new_value) {
+	*value = new_value;
+}
+
+// x64 loads and stores already have acquire/release ordering; the barriers
+// only stop the compiler from moving accesses across them.
+int64_t platform_atomic_load_acquire_i64(volatile int64_t* value) {
+	int64_t result = *value;
+	_ReadWriteBarrier();
+	return result;
+}
+
+void platform_atomic_store_release_i64(volatile int64_t* value, int64_t new_value) {
+	_ReadWriteBarrier();
+	*value = new_value;
+}
+
+void* platform_atomic_load_ptr(void* volatile* value) {
+	return InterlockedCompareExchangePointer(value, 0, 0);
+}
+
+void platform_atomic_store_ptr(void* volatile* value, void* new_value) {
+	InterlockedExchangePointer(value, new_value);
+}
+
+void* platform_atomic_exchange_ptr(void* volatile* value, void* new_value) {
+	return InterlockedExchangePointer(value, new_value);
+}
+
+bool platform_atomic_compare_exchange_ptr(void* volatile* value, void** expected, void* desired) {
+	void* previous = InterlockedCompareExchangePointer(value, desired, *expected);
+	if (previous == *expected) {
+		return true;
+	}
+	*expected = previous;
+	return false;
+}
+
+void platform_atomic_thread_fence() {
+	MemoryBarrier();
+}
+
+void platform_cpu_pause() {
+	YieldProcessor();
+}
+
+void platform_get_required_extension_names(const char*** names_darray) {
+	darray_push(*names_darray, &"VK_KHR_win32_surface");
+}
+
+bool platform_create_vulkan_surface(vulkan_context *context) {
+	if (!state_ptr) {
+		return false;
+	}
+
+	VkWin32SurfaceCreateInfoKHR create_info = {VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR };
+	create_info.hinstance = state_ptr->h_instance;
+	create_info.hwnd = state_ptr->hwnd;
+
+	VkResult result = vkCreateWin32SurfaceKHR(context->instance, &create_info, context->allocator, &state_ptr->surface);
+	if (result != VK_SUCCESS) {
+		KFATAL("Vulkan surface creation failed");
+		return false;
+	}
+
+	context->surface = state_ptr->surface;
+
+	return true;
+}
+
+LRESULT CALLBACK win32_process_message(HWND hwnd, uint32_t msg, WPARAM w_param, LPARAM l_param) {
+	switch (msg) {
+	case WM_ERASEBKGND:
+		return 1;
+	case WM_CLOSE:
+		event_context data;
+		event_fire(EVENT_CODE_APPLICATION_QUIT, 0, data);
+		return TRUE;
+	case WM_DESTROY:
+		PostQuitMessage(0);
+		return 0;
+	case WM_SIZE: {
+		RECT r;
+		GetClientRect(hwnd, &r);
+		uint32_t width = r.right - r.left;
+		uint32_t height = r.bottom - r.top;
+	
+		event_context context;
+		context.data.u16[0] = (uint16_t)width;
+		context.data.u16[1] = (uint16_t)height;
+		event_fire(EVENT_CODE_RESIZED, 0, context);
+	}break;
+	case WM_KEYDOWN:
+	case WM_SYSKEYDOWN:
+	case WM_KEYUP:
+	case WM_SYSKEYUP: {
+		int8_t pressed = (msg == WM_KEYDOWN || msg == WM_SYSKEYDOWN);
+		keys key = (uint16_t)w_param;
+	
+		input_process_key(key, pressed);
+	} break;
+	case WM_MOUSEMOVE: {
+		int32_t x_position = GET_X_LPARAM(l_param);
+		int32_t y_position = GET_Y_LPARAM(l_param);
+
+		input_process_mouse_move(x_position, y_position);
+	} break;
+	case WM_MOUSEWHEEL: {
+		int32_t z_delta = GET_WHEEL_DELTA_WPARAM(w_param);
+		if (z_delta != 0) {
+			z_delta = (z_delta < 0) ? -1 : 1;
+			input_process_mouse_wheel(z_delta);
+		}
+	} break;
+	case WM_LBUTTONDOWN:
+	case WM_MBUTTONDOWN:
+	case WM_RBUTTONDOWN:
+	case WM_LBUTTONUP:
+	case WM_MBUTTONUP:
+	case WM_RBUTTONUP: {
+		int8_t pressed = msg == WM_LBUTTONDOWN || msg == WM_RBUTTONDOWN || msg == WM_MBUTTONDOWN;
+		buttons mouse_button = BUTTON_MAX_BUTTONS;
+		switch (msg) {
+		case WM_LBUTTONDOWN:
+		case WM_LBUTTONUP:
+			mouse_button = BUTTON_LEFT;
+			break;
+		case WM_MBUTTONDOWN:
+		case WM_MBUTTONUP:
+			mouse_button = BUTTON_MIDDLE;
+			break;
+		case WM_RBUTTONDOWN:
+		case WM_RBUTTONUP:
+			mouse_button = BUTTON_RIGHT;
+			break;
+		}
+
+		if (mouse_button != BUTTON_MAX_BUTTONS) {
+			input_process_button(mouse_button, pressed);
+		}
+	}break; 
+	}//switch
+
+	return DefWindowProcA(hwnd, msg, w_param, l_param);
+}
+
 #endif // Platform WINDOW
\ No newline at end of file
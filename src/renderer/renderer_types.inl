@@ -3,6 +3,9 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+// Frames the CPU may record ahead of the GPU before waiting on a fence.
+#define RENDERER_MAX_FRAMES_IN_FLIGHT 2
+
 typedef enum renderer_backend_type{
 	RENDERER_BACKEND_TYPE_VULKAN,
 	RENDERER_BACKEND_TYPE_OPENGL,
@@ -56,7 +56,9 @@ bool vulkan_renderer_backend_initialize(renderer_backend* backend, const char* a
 	VkInstanceCreateInfo create_info = { VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO };
 	create_info.pApplicationInfo = &app_info;
 	
-	const char** required_extensions = darray_create(const char*);
+	// The instance copies these lists, so they only need to outlive this function.
+	darray_allocator scratch = DARRAY_FRAME(application_get_frame_allocator());
+	const char** required_extensions = darray_create_from(const char*, scratch);
 	darray_push(required_extensions, &VK_KHR_SURFACE_EXTENSION_NAME);
 	platform_get_required_extension_names(&required_extensions);
 #if defined(_DEBUG)
@@ -79,13 +81,13 @@ bool vulkan_renderer_backend_initialize(renderer_backend* backend, const char* a
 #if defined(_DEBUG)
 	KINFO("Validation layers enabled. Enumerating ...");
 
-	required_validation_layer_names = darray_create(const char*);
+	required_validation_layer_names = darray_create_from(const char*, scratch);
 	darray_push(required_validation_layer_names, &"VK_LAYER_KHRONOS_validation");
 	required_validation_layer_count = darray_length(required_validation_layer_names);
 
 	uint32_t available_layer_count = 0;
 	VK_CHECK(vkEnumerateInstanceLayerProperties(&available_layer_count, 0));
-	VkLayerProperties* available_layers = darray_reserve(VkLayerProperties, available_layer_count);
+	VkLayerProperties* available_layers = darray_create_with_capacity_from(VkLayerProperties, available_layer_count, scratch);
 	VK_CHECK(vkEnumerateInstanceLayerProperties(&available_layer_count, available_layers));
 
 	for (uint32_t i = 0; i < required_validation_layer_count; ++i) {
@@ -156,15 +158,15 @@ bool vulkan_renderer_backend_initialize(renderer_backend* backend, const char* a
 		0.0f, 0.0f, 0.2f, 1.0f,
 		1.0f, 0);
 
-	context.swapchain.framebuffers = darray_reserve(vulkan_framebuffer, context.swapchain.image_count);
+	context.swapchain.framebuffers = darray_create_with_capacity(vulkan_framebuffer, context.swapchain.image_count);
 	regenerate_framebuffers(backend, &context.swapchain, &context.main_renderpass);
 
 
 	create_command_buffers(backend);
 
-	context.image_available_semaphores = darray_reserve(VkSemaphore, context.swapchain.max_frams_in_flight);
-	context.queue_complete_semaphores = darray_reserve(VkSemaphore, context.swapchain.max_frams_in_flight);
-	context.in_flight_fences = darray_reserve(vulkan_fence, context.swapchain.max_frams_in_flight);
+	context.image_available_semaphores = darray_create_with_capacity(VkSemaphore, context.swapchain.max_frams_in_flight);
+	context.queue_complete_semaphores = darray_create_with_capacity(VkSemaphore, context.swapchain.max_frams_in_flight);
+	context.in_flight_fences = darray_create_with_capacity(vulkan_fence, context.swapchain.max_frams_in_flight);
 
 	for (uint8_t i = 0; i < context.swapchain.max_frams_in_flight; ++i) {
 		VkSemaphoreCreateInfo semaphore_create_info = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
@@ -174,7 +176,7 @@ bool vulkan_renderer_backend_initialize(renderer_backend* backend, const char* a
 		vulkan_fence_create(&context, true, &context.in_flight_fences[i]);
 	}
 
-	context.images_in_flight = darray_reserve(vulkan_fence, context.swapchain.image_count);
+	context.images_in_flight = darray_create_with_capacity(vulkan_fence, context.swapchain.image_count);
 	for (uint32_t i = 0; i < context.swapchain.image_count; ++i) {
 		context.images_in_flight[i] = 0;
 	}
@@ -439,7 +441,7 @@ int32_t find_memory_index(uint32_t type_filter, uint32_t property_flags) {
 
 void create_command_buffers(renderer_backend* backend) {
 	if (!context.graphics_command_buffers) {
-		context.graphics_command_buffers = darray_reserve(vulkan_command_buffer, context.swapchain.image_count);
+		context.graphics_command_buffers = darray_create_with_capacity(vulkan_command_buffer, context.swapchain.image_count);
 		for (uint32_t i = 0; i < context.swapchain.image_count; ++i) {
 			gzero_memory(&context.graphics_command_buffers[i], sizeof(vulkan_command_buffer));
 		}
@@ -3,6 +3,9 @@
 #include "../../core/gstring.h"
 #include "../../core/gmemory.h"
 #include "../../containers/darray.h"
+#include "../../containers/small_vector.h"
+
+SMALL_VECTOR_DEFINE(extension_names, const char*, 4);
 
 typedef struct vulkan_physical_device_requirements {
 	int8_t graphics;
@@ -10,7 +13,7 @@ typedef struct vulkan_physical_device_requirements {
 	int8_t compute;
 	int8_t transfer;
 
-	const char** device_extension_names;
+	small_vector_extension_names device_extension_names;
 	int8_t sampler_anisotropy;
 	int8_t discrete_gpu;
 } vulkan_physical_device_requirements;
@@ -192,7 +195,7 @@ void vulkan_device_query_swapchain_support(
 
 	if (out_support_info->format_count != 0) {
 		if (!out_support_info->formats) {
-			out_support_info->formats = gallocate(sizeof(VkSurfaceFormatKHR) * out_support_info->format_count, MEMORY_TAG_RENDERER);
+			out_support_info->formats = gallocate_flags(sizeof(VkSurfaceFormatKHR) * out_support_info->format_count, MEMORY_TAG_RENDERER, MEMORY_FLAG_LONG_LIVED);
 		}
 		VK_CHECK(vkGetPhysicalDeviceSurfaceFormatsKHR(
 			physical_device,
@@ -210,7 +213,7 @@ void vulkan_device_query_swapchain_support(
 
 	if (out_support_info->present_mode_count != 0) {
 		if (!out_support_info->present_modes) {
-			out_support_info->present_modes = gallocate(sizeof(VkPresentModeKHR) * out_support_info->present_mode_count, MEMORY_TAG_RENDERER);
+			out_support_info->present_modes = gallocate_flags(sizeof(VkPresentModeKHR) * out_support_info->present_mode_count, MEMORY_TAG_RENDERER, MEMORY_FLAG_LONG_LIVED);
 		}
 		VK_CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(
 			physical_device,
@@ -274,8 +277,8 @@ int8_t select_physical_device(vulkan_context* context) {
 		requirements.transfer = 1;
 		requirements.sampler_anisotropy = 1;
 		requirements.discrete_gpu = 1;
-		requirements.device_extension_names = darray_create(const char**);
-		darray_push(requirements.device_extension_names, &VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+		small_vector_extension_names_init(&requirements.device_extension_names, DARRAY_HEAP);
+		small_vector_extension_names_push(&requirements.device_extension_names, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
 		vulkan_physical_device_queue_family_info queue_info = { 0 };
 		int8_t result = physical_device_meets_requirements(
@@ -286,6 +289,7 @@ int8_t select_physical_device(vulkan_context* context) {
 			&requirements,
 			&queue_info,
 			&context->device.swapchain_support);
+		small_vector_extension_names_destroy(&requirements.device_extension_names);
 
 		if (result) {
 			KINFO("Selected device: '%s'.", properties.deviceName);
@@ -440,7 +444,7 @@ int8_t physical_device_meets_requirements(
 			return 0;
 		}
 
-		if (requirements->device_extension_names) {
+		if (small_vector_extension_names_length(&requirements->device_extension_names)) {
 			uint32_t available_extension_count = 0;
 			VkExtensionProperties* available_extensions = 0;
 			VK_CHECK(vkEnumerateDeviceExtensionProperties(
@@ -456,18 +460,19 @@ int8_t physical_device_meets_requirements(
 					&available_extension_count,
 					available_extensions));
 				
-				uint32_t required_extension_count = darray_length(requirements->device_extension_names);
+				const char** required_extension_names = small_vector_extension_names_data(&requirements->device_extension_names);
+				uint32_t required_extension_count = small_vector_extension_names_length(&requirements->device_extension_names);
 				for (uint32_t i = 0; i < required_extension_count; ++i) {
 					int8_t found = 0;
 					for (uint32_t j = 0; j < available_extension_count; ++j) {
-						if (strings_equal(requirements->device_extension_names[i], available_extensions[j].extensionName)) {
+						if (strings_equal(required_extension_names[i], available_extensions[j].extensionName)) {
 							found = 1;
 							break;
 						}
 					}
 
 					if (!found) {
-						KINFO("Required extension not found: '%s' skipping device", requirements->device_extension_names[i]);
+						KINFO("Required extension not found: '%s' skipping device", required_extension_names[i]);
 						gfree(available_extensions, sizeof(VkExtensionProperties)* available_extension_count, MEMORY_TAG_RENDERER);
 						return 0;
 					}
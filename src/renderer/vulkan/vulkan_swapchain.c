@@ -4,6 +4,7 @@
 #include "../../core/gmemory.h"
 #include "vulkan_device.h"
 #include "vulkan_image.h"
+#include "../renderer_types.inl"
 
 void create(vulkan_context* context, uint32_t width, uint32_t height, vulkan_swapchain* swap_chain);
 void destroy(vulkan_context* context, vulkan_swapchain* swapchain);
@@ -87,7 +88,7 @@ void vulkan_swapchain_present(
 
 void create(vulkan_context* context, uint32_t width, uint32_t height, vulkan_swapchain* swapchain) {
 	VkExtent2D swapchain_extent = { width, height };
-	swapchain->max_frams_in_flight = 2;
+	swapchain->max_frams_in_flight = RENDERER_MAX_FRAMES_IN_FLIGHT;
 
 	int8_t found = 0;
 	for (uint32_t i = 0; i < context->device.swapchain_support.format_count; ++i) {
@@ -171,10 +172,10 @@ void create(vulkan_context* context, uint32_t width, uint32_t height, vulkan_swa
 	swapchain->image_count = 0;
 	VK_CHECK(vkGetSwapchainImagesKHR(context->device.logical_device, swapchain->handle, &swapchain->image_count, 0));
 	if (!swapchain->images) {
-		swapchain->images = (VkImage*)gallocate(sizeof(VkImage) * swapchain->image_count, MEMORY_TAG_RENDERER);
+		swapchain->images = (VkImage*)gallocate_flags(sizeof(VkImage) * swapchain->image_count, MEMORY_TAG_RENDERER, MEMORY_FLAG_LONG_LIVED);
 	}
 	if (!swapchain->views) {
-		swapchain->views = (VkImageView*)gallocate(sizeof(VkImageView) * swapchain->image_count, MEMORY_TAG_RENDERER);
+		swapchain->views = (VkImageView*)gallocate_flags(sizeof(VkImageView) * swapchain->image_count, MEMORY_TAG_RENDERER, MEMORY_FLAG_LONG_LIVED);
 	}
 
 	VK_CHECK(vkGetSwapchainImagesKHR(context->device.logical_device, swapchain->handle, &swapchain->image_count, swapchain->images));